@@ -1,42 +1,188 @@
+import 'dart:ffi';
 import 'dart:io';
+import 'package:ffi/ffi.dart';
 import '../services/icon_provider.dart';
 
+/// `applications/` directories in priority order: XDG_DATA_HOME, each
+/// XDG_DATA_DIRS entry, then the Flatpak and Snap export directories in case
+/// the session did not add them to XDG_DATA_DIRS.
+List<String> applicationDirs() {
+  final env = Platform.environment;
+  final home = env['HOME'];
+  final dataHome = (env['XDG_DATA_HOME']?.isNotEmpty ?? false)
+      ? env['XDG_DATA_HOME']!
+      : (home != null ? '$home/.local/share' : null);
+  final dataDirs = (env['XDG_DATA_DIRS']?.isNotEmpty ?? false)
+      ? env['XDG_DATA_DIRS']!.split(':')
+      : const ['/usr/local/share', '/usr/share'];
+
+  final dirs = <String>{
+    if (dataHome != null) '$dataHome/applications',
+    for (final d in dataDirs)
+      if (d.isNotEmpty) '${d.endsWith('/') ? d.substring(0, d.length - 1) : d}/applications',
+    if (dataHome != null) '$dataHome/flatpak/exports/share/applications',
+    '/var/lib/flatpak/exports/share/applications',
+    '/var/lib/snapd/desktop/applications',
+  };
+  return dirs.toList();
+}
+
+/// Desktop-file ID: the path below `applications/` with '/' replaced by '-'.
+String desktopFileId(String appsDir, String path) {
+  return path.substring(appsDir.length + 1).replaceAll('/', '-');
+}
+
+/// Locale names to match `Name[xx]` keys against, most preferred first,
+/// taken from the first of LANGUAGE, LC_ALL, LC_MESSAGES and LANG that is
+/// set. `de_DE.UTF-8@euro` gives `de_DE@euro`, `de_DE`, `de@euro` and `de`,
+/// as g_get_language_names does in the GTK dock.
+List<String> languageNames() => _languageNames ??= _readLanguageNames();
+
+List<String>? _languageNames;
+
+List<String> _readLanguageNames() {
+  final env = Platform.environment;
+  final value = ['LANGUAGE', 'LC_ALL', 'LC_MESSAGES', 'LANG']
+      .map((key) => env[key])
+      .firstWhere((v) => v != null && v.isNotEmpty, orElse: () => null);
+  final locale = RegExp(r'^([^_.@]+)(_[^.@]+)?(\.[^@]*)?(@.+)?$');
+  final names = <String>[];
+  for (final entry in value?.split(':') ?? const <String>[]) {
+    final m = locale.firstMatch(entry);
+    if (m == null) continue;
+    final lang = m.group(1)!;
+    final country = m.group(2) ?? '';
+    final modifier = m.group(4) ?? '';
+    for (final name in ['$lang$country$modifier', '$lang$country', '$lang$modifier', lang]) {
+      if (name != 'C' && name != 'POSIX' && !names.contains(name)) names.add(name);
+    }
+  }
+  return names;
+}
+
+const String _accented =
+    'àáâãäåāăąçćĉċčďđèéêëēĕėęěĝğġģĥħìíîïĩīĭįıĵķĺļľŀłñńņňòóôõöøōŏőŕŗřśŝşšţťŧùúûüũūŭůűųŵýÿŷźżž';
+const String _unaccented =
+    'aaaaaaaaacccccddeeeeeeeeegggghhiiiiiiiiijklllllnnnnooooooooorrrsssstttuuuuuuuuuuwyyyzzz';
+
+final Map<int, String> _fold = {
+  for (var i = 0; i < _accented.length; ++i) _accented.codeUnitAt(i): _unaccented[i],
+  0xDF: 'ss', // ß
+  0xE6: 'ae', // æ
+  0x153: 'oe', // œ
+};
+
+/// GLib's case folding and collation, as used by the GTK dock. GLib is
+/// always loaded under the Linux runner, which links GTK and sets the
+/// locale; elsewhere (e.g. `flutter test`) it may be missing.
+class _GlibCollation {
+  _GlibCollation(DynamicLibrary glib)
+      : _casefold = glib.lookupFunction<Pointer<Utf8> Function(Pointer<Utf8>, IntPtr),
+            Pointer<Utf8> Function(Pointer<Utf8>, int)>('g_utf8_casefold'),
+        _collateKey = glib.lookupFunction<Pointer<Utf8> Function(Pointer<Utf8>, IntPtr),
+            Pointer<Utf8> Function(Pointer<Utf8>, int)>('g_utf8_collate_key'),
+        _free = glib.lookupFunction<Void Function(Pointer<Void>),
+            void Function(Pointer<Void>)>('g_free');
+
+  final Pointer<Utf8> Function(Pointer<Utf8>, int) _casefold;
+  final Pointer<Utf8> Function(Pointer<Utf8>, int) _collateKey;
+  final void Function(Pointer<Void>) _free;
+
+  static final _GlibCollation? instance = _open();
+
+  static _GlibCollation? _open() {
+    try {
+      return _GlibCollation(DynamicLibrary.open('libglib-2.0.so.0'));
+    } on ArgumentError {
+      return null;
+    }
+  }
+
+  /// g_utf8_collate_key of the case-folded name, exactly as the GTK dock
+  /// computes it. The key is a byte string (strxfrm output), kept one
+  /// byte per code unit so String.compareTo orders it like strcmp.
+  String key(String name) {
+    final utf8 = name.toNativeUtf8();
+    final folded = _casefold(utf8, -1);
+    final key = _collateKey(folded, -1);
+    final bytes = key.cast<Uint8>().asTypedList(key.length);
+    final result = String.fromCharCodes(bytes);
+    _free(key.cast());
+    _free(folded.cast());
+    malloc.free(utf8);
+    return result;
+  }
+}
+
+/// Sort key for an application name, computed once per entry so sorting is
+/// a plain string comparison.
+///
+/// With GLib available this is the GTK dock's key: g_utf8_collate_key of
+/// the case-folded name under the user's LC_COLLATE, so both docks order
+/// the same list identically (å, ä and ö after z under sv_SE, Cyrillic and
+/// CJK names by locale rules). Without GLib it falls back to a fixed fold
+/// where case and Latin accents only break ties; that fallback ignores the
+/// locale and orders non-Latin scripts by UTF-16 code unit.
+String collationKey(String name) {
+  final glib = _GlibCollation.instance;
+  if (glib != null) return glib.key(name);
+
+  final lower = name.toLowerCase();
+  final key = StringBuffer();
+  for (final unit in lower.codeUnits) {
+    final folded = _fold[unit];
+    if (folded != null) {
+      key.write(folded);
+    } else {
+      key.writeCharCode(unit);
+    }
+  }
+  key
+    ..writeCharCode(0)
+    ..write(lower);
+  return key.toString();
+}
+
 class DesktopEntry {
+  final String id;
   final String name;
   final String? exec;
   late final String? iconPath;
   final bool isSvgIcon;
+  final String sortKey;
 
   DesktopEntry({
+    this.id = '',
     required this.name,
     this.exec,
     this.iconPath,
     this.isSvgIcon = false,
-  });
+  }) : sortKey = collationKey(name);
 
-  static Future<List<DesktopEntry>> loadAll() async {
-    final List<String> dirs = [
-      '/usr/share/applications',
-      '/usr/local/share/applications',
-      if (Platform.environment['XDG_DATA_HOME'] != null)
-        '${Platform.environment['XDG_DATA_HOME']!}/applications'
-      else
-        Platform.environment['HOME'] != null
-            ? '${Platform.environment['HOME']!}/.local/share/applications'
-            : '',
-    ];
+  static Future<List<DesktopEntry>>? _shared;
+
+  /// Application list shared by every surface running in this engine.
+  static Future<List<DesktopEntry>> shared() => _shared ??= loadAll();
 
+  static Future<List<DesktopEntry>> loadAll() async {
+    // The first file seen for a desktop-file ID owns it, even when it is
+    // hidden, so user overrides mask system entries.
     final Set<String> seen = {};
     final List<DesktopEntry> entries = [];
+    final languages = languageNames();
 
-    for (final dir in dirs) {
+    for (final dir in applicationDirs()) {
       final d = Directory(dir);
       if (!await d.exists()) continue;
-      await for (final file in d.list()) {
+      await for (final file in d.list(recursive: true, followLinks: false)) {
         if (!file.path.endsWith('.desktop')) continue;
+        final id = desktopFileId(dir, file.path);
+        if (!seen.add(id)) continue;
         try {
           final lines = await File(file.path).readAsLines();
           String? name;
+          String? localName;
+          var localRank = languages.length;
           String? exec;
           String? icon;
           bool inDesktopEntry = false;
@@ -49,9 +195,18 @@ class DesktopEntry {
               inDesktopEntry = true;
               continue;
             }
+            if (inDesktopEntry && l.startsWith('[')) break;
             if (!inDesktopEntry || l.startsWith('#')) continue;
             
             if (l.startsWith('Name=')) name = l.substring(5);
+            if (l.startsWith('Name[')) {
+              final close = l.indexOf(']=');
+              final rank = close > 5 ? languages.indexOf(l.substring(5, close)) : -1;
+              if (rank >= 0 && rank < localRank) {
+                localName = l.substring(close + 2);
+                localRank = rank;
+              }
+            }
             if (l.startsWith('Exec=')) exec = l.substring(5);
             if (l.startsWith('Icon=')) icon = l.substring(5);
             
@@ -83,13 +238,14 @@ class DesktopEntry {
             }
           }
           
-          if (name != null && exec != null && shouldDisplay && !seen.contains(name)) {
-            seen.add(name);
+          name = localName ?? name;
+          if (name != null && exec != null && shouldDisplay) {
             if (icon != null) {
               final iconPath = icon.startsWith('/') ? icon : IconProvider.findIcon(icon);
               if (iconPath != null) {
                 entries.add(
                   DesktopEntry(
+                    id: id,
                     name: name,
                     exec: exec,
                     iconPath: iconPath,
@@ -97,10 +253,10 @@ class DesktopEntry {
                   ),
                 );
               } else {
-                entries.add(DesktopEntry(name: name, exec: exec));
+                entries.add(DesktopEntry(id: id, name: name, exec: exec));
               }
             } else {
-              entries.add(DesktopEntry(name: name, exec: exec));
+              entries.add(DesktopEntry(id: id, name: name, exec: exec));
             }
           }
         } catch (_) {
@@ -108,9 +264,7 @@ class DesktopEntry {
         }
       }
     }
-    entries.sort(
-      (a, b) => a.name.toLowerCase().compareTo(b.name.toLowerCase()),
-    );
+    entries.sort((a, b) => a.sortKey.compareTo(b.sortKey));
     return entries;
   }
 }
\ No newline at end of file
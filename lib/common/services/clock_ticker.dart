@@ -0,0 +1,69 @@
+import 'dart:async';
+import 'package:flutter/foundation.dart';
+import 'wakeup_counter.dart';
+
+/// Wall-clock notifier that only wakes up when the displayed time changes.
+///
+/// Instead of a free-running periodic timer, each tick arms a one-shot timer
+/// aligned to the next minute boundary, or the next second boundary while
+/// [showSeconds] is on. The timer only runs while someone is listening.
+class ClockTicker extends ValueNotifier<DateTime> {
+  ClockTicker({bool showSeconds = false})
+      : _showSeconds = showSeconds,
+        super(DateTime.now());
+
+  static final ClockTicker instance = ClockTicker();
+
+  bool _showSeconds;
+  Timer? _timer;
+
+  bool get showSeconds => _showSeconds;
+
+  set showSeconds(bool value) {
+    if (value == _showSeconds) return;
+    _showSeconds = value;
+    // With no listeners the timer is off and addListener re-arms it.
+    if (hasListeners) _tick();
+  }
+
+  @override
+  void addListener(VoidCallback listener) {
+    final wasIdle = !hasListeners;
+    super.addListener(listener);
+    if (wasIdle) _tick();
+  }
+
+  @override
+  void removeListener(VoidCallback listener) {
+    super.removeListener(listener);
+    if (!hasListeners) {
+      _timer?.cancel();
+      _timer = null;
+    }
+  }
+
+  void _tick() {
+    _timer?.cancel();
+    final now = DateTime.now();
+    value = now;
+    final Duration delay;
+    if (_showSeconds) {
+      delay = Duration(milliseconds: 1000 - now.millisecond);
+    } else {
+      delay = Duration(
+        seconds: 59 - now.second,
+        milliseconds: 1000 - now.millisecond,
+      );
+    }
+    _timer = Timer(delay, () {
+      WakeupCounter.record('clock');
+      _tick();
+    });
+  }
+
+  @override
+  void dispose() {
+    _timer?.cancel();
+    super.dispose();
+  }
+}
@@ -0,0 +1,64 @@
+import 'dart:typed_data';
+import 'dart:ui' show FrameTiming;
+import 'package:flutter/scheduler.dart';
+
+/// Per-frame build and raster times reported by the engine.
+///
+/// [start] registers a timings callback; the engine batches timings, so it
+/// costs nothing while no frames are drawn. [report] gives percentiles and
+/// the number of frames over budget since the last report, e.g. after
+/// dragging a quick-settings slider. Run `vaxp_panel --frame-stats` against
+/// a resident instance to print it.
+///
+/// Only the last [capacity] frames are kept, in fixed-size ring buffers, so
+/// a panel that is never asked for a report does not grow.
+class FrameStats {
+  static const Duration budget = Duration(microseconds: 16667);
+  static const int capacity = 600;
+
+  static final Int32List _build = Int32List(capacity);
+  static final Int32List _raster = Int32List(capacity);
+  static int _next = 0;
+  static int _count = 0;
+  static int _dropped = 0;
+  static bool _started = false;
+
+  static void start() {
+    if (_started) return;
+    _started = true;
+    SchedulerBinding.instance.addTimingsCallback(_onTimings);
+  }
+
+  static void _onTimings(List<FrameTiming> timings) {
+    for (final t in timings) {
+      _build[_next] = t.buildDuration.inMicroseconds;
+      _raster[_next] = t.rasterDuration.inMicroseconds;
+      _next = (_next + 1) % capacity;
+      if (_count < capacity) {
+        _count++;
+      } else {
+        _dropped++;
+      }
+    }
+  }
+
+  static String _summary(String name, Int32List samples) {
+    if (_count == 0) return '$name: -';
+    final sorted = Int32List.fromList(samples.sublist(0, _count))..sort();
+    String ms(int us) => (us / 1000).toStringAsFixed(2);
+    final over = sorted.where((us) => us > budget.inMicroseconds).length;
+    return '$name p50=${ms(sorted[sorted.length ~/ 2])}ms '
+        'p90=${ms(sorted[(sorted.length * 9) ~/ 10])}ms '
+        'max=${ms(sorted.last)}ms over_budget=$over';
+  }
+
+  static String report() {
+    final dropped = _dropped > 0 ? ' (oldest $_dropped not kept)' : '';
+    final line = 'frames: ${_count + _dropped}$dropped '
+        '${_summary('build', _build)} ${_summary('raster', _raster)}';
+    _next = 0;
+    _count = 0;
+    _dropped = 0;
+    return line;
+  }
+}
@@ -3,11 +3,12 @@ import 'dart:io' show Platform, Directory, File;
 import 'package:path/path.dart' as path;
 import 'package:ffi/ffi.dart';
 import 'package:flutter/material.dart';
+import 'icon_provider.dart';
 
 class IconLoader {
   static late final DynamicLibrary _lib;
   static late final void Function() _initGtk;
-  static late final Pointer<Utf8> Function(Pointer<Utf8>, int) _getIconPath;
+  static late final Pointer<Utf8> Function(Pointer<Utf8>, int, int) _getIconPath;
   static late final void Function(Pointer<Utf8>) _freeIconPath;
   static bool _initialized = false;
   static bool _gtkAvailable = true;
@@ -21,8 +22,8 @@ class IconLoader {
         _lib = DynamicLibrary.open(libraryPath);
         _initGtk = _lib.lookupFunction<Void Function(), void Function()>('init_gtk');
         _getIconPath = _lib.lookupFunction<
-            Pointer<Utf8> Function(Pointer<Utf8>, Int32),
-            Pointer<Utf8> Function(Pointer<Utf8>, int)>('get_icon_path');
+            Pointer<Utf8> Function(Pointer<Utf8>, Int32, Int32),
+            Pointer<Utf8> Function(Pointer<Utf8>, int, int)>('get_icon_path_for_scale');
         _freeIconPath = _lib.lookupFunction<
             Void Function(Pointer<Utf8>),
             void Function(Pointer<Utf8>)>('free_icon_path');
@@ -37,15 +38,15 @@ class IconLoader {
     }
   }
 
-  static ImageProvider<Object>? getIcon(String iconName, {int size = 48}) {
+  static ImageProvider<Object>? getIcon(String iconName, {int size = 48, double? scale}) {
     if (_gtkAvailable) {
       if (!_initialized) initialize();
       
       if (_initialized) {
         try {
-          final iconPath = getIconPath(iconName, size: size);
+          final iconPath = getIconPath(iconName, size: size, scale: scale);
           if (iconPath != null) {
-            return _createImageProvider(iconPath);
+            return _createImageProvider(iconPath, size, scale);
           }
         } catch (e) {
           print('GTK icon lookup failed: $e');
@@ -55,12 +56,14 @@ class IconLoader {
     return null;
   }
 
-  static String? getIconPath(String iconName, {int size = 48}) {
+  /// Path of [iconName] for [size] logical pixels at [scale] (the device
+  /// pixel ratio by default), resolved by GTK for the integer scale above.
+  static String? getIconPath(String iconName, {int size = 48, double? scale}) {
     if (!_initialized) initialize();
     if (!_gtkAvailable) return null;
 
     final iconNamePtr = iconName.toNativeUtf8();
-    final resultPtr = _getIconPath(iconNamePtr, size);
+    final resultPtr = _getIconPath(iconNamePtr, size, (scale ?? IconProvider.deviceScale).ceil());
     malloc.free(iconNamePtr);
 
     if (resultPtr.address == 0) return null;
@@ -105,7 +108,7 @@ class IconLoader {
     return false;
   }
 
-  static ImageProvider<Object>? _createImageProvider(String path) {
+  static ImageProvider<Object>? _createImageProvider(String path, int size, double? scale) {
     if (!File(path).existsSync()) {
       print('File does not exist: $path');
       return null;
@@ -116,7 +119,7 @@ class IconLoader {
         print('Skipping SVG file: $path');
         return null;
       }
-      return FileImage(File(path));
+      return IconProvider.fileImage(path, size: size, scale: scale);
     } catch (e) {
       print('Error creating image provider for $path: $e');
       return null;
@@ -1,89 +1,311 @@
 import 'dart:io';
+import 'dart:ui' show PlatformDispatcher;
 import 'package:flutter/material.dart';
+import 'wakeup_counter.dart';
+
+/// A theme directory as described by index.theme (or guessed from its name).
+class _ThemeDir {
+  final String path;
+  final int size;
+  final int scale;
+  final bool scalable;
+
+  const _ThemeDir(this.path, this.size, this.scale, this.scalable);
+
+  int get physical => size * scale;
+}
+
+/// One theme of the lookup chain, with its directories under every base.
+class _Theme {
+  final List<_ThemeDir> dirs;
+  final Map<int, List<_ThemeDir>> _orders = {};
+
+  _Theme(this.dirs);
+
+  /// [dirs] in the order they are searched for [physical] pixels: the
+  /// smallest at or above it, then scalable ones, then the largest below.
+  /// Ties keep the base order, so user themes mask system ones.
+  List<_ThemeDir> orderFor(int physical) => _orders.putIfAbsent(physical, () {
+        int rank(_ThemeDir d) => d.scalable ? 1 : (d.physical >= physical ? 0 : 2);
+        final indexed = [for (var i = 0; i < dirs.length; i++) (i, dirs[i])];
+        indexed.sort((a, b) {
+          final ra = rank(a.$2), rb = rank(b.$2);
+          if (ra != rb) return ra - rb;
+          final bySize = switch (ra) {
+            0 => a.$2.physical - b.$2.physical,
+            2 => b.$2.physical - a.$2.physical,
+            _ => 0,
+          };
+          return bySize != 0 ? bySize : a.$1 - b.$1;
+        });
+        return [for (final e in indexed) e.$2];
+      });
+}
 
 class IconProvider {
-  static String? findIcon(String iconName) {
+  /// Canonical icon sizes in logical pixels. Requests are rounded up to one
+  /// of these so that widgets asking for, say, 44 and 48 px share both the
+  /// resolved path and the decoded image.
+  static const List<int> sizeBuckets = [16, 24, 32, 48, 64, 96, 128, 256, 512];
+
+  static int bucket(int size) =>
+      sizeBuckets.firstWhere((b) => b >= size, orElse: () => sizeBuckets.last);
+
+  /// Device pixel ratio of the first view, used when no scale is given.
+  static double get deviceScale {
+    final views = PlatformDispatcher.instance.views;
+    return views.isEmpty ? 1.0 : views.first.devicePixelRatio;
+  }
+
+  static final Map<String, String?> _resolved = {};
+  static List<_Theme>? _themes;
+  // Icon name -> file for each theme directory listed so far.
+  static final Map<String, Map<String, String>> _listings = {};
+  static bool _watching = false;
+
+  /// Icon base directories and theme name used instead of the system's,
+  /// so tests and benchmarks can run against a generated theme. The theme
+  /// setting is neither read nor watched while they are set.
+  @visibleForTesting
+  static List<String>? debugBases;
+  @visibleForTesting
+  static String? debugThemeName;
+
+  /// Finds the file for [iconName] drawn at [size] logical pixels.
+  ///
+  /// Only the active theme, the themes it inherits from and hicolor are
+  /// searched. Within the first theme that has the icon, the smallest size at
+  /// or above the physical target (bucketed size times [scale], the device
+  /// pixel ratio by default) wins, then a scalable icon, then the largest
+  /// smaller one. Theme directories are listed lazily, at most one per
+  /// lookup; the others are probed for the icon's file names.
+  static String? findIcon(String iconName, {int size = 48, double? scale}) {
     if (iconName.isEmpty) return null;
-    
-    if (iconName.startsWith('/') && File(iconName).existsSync()) {
-      return iconName;
+
+    if (iconName.startsWith('/')) {
+      return File(iconName).existsSync() ? iconName : null;
     }
-    
-    final systemPaths = [
-      '/usr/share/icons',
-      '/usr/local/share/icons',
-      '/usr/share/pixmaps',
-      '/usr/local/share/pixmaps',
-      '${Platform.environment['HOME']}/.icons',
-      '${Platform.environment['HOME']}/.local/share/icons',
-      '/var/lib/flatpak/exports/share/icons',
-      '${Platform.environment['HOME']}/.local/share/flatpak/exports/share/icons',
-      '/var/lib/snapd/desktop/icons',
-    ].where((path) => Directory(path).existsSync()).toList();
-    
-    final themeSearchOrder = [
-      _detectIconTheme(),
-      'hicolor',
-      'Adwaita',
-      'gnome',
-      'oxygen',
-      'Humanity',
-      'elementary',
-      'breeze',
-      'Papirus',
-      'Numix',
-      'default',
-    ].where((theme) => theme != null).toSet().toList();
-    
-    final sizes = ['512x512', '256x256', '128x128', '96x96', '72x72', '64x64', '48x48', '32x32', '24x24', '22x22', '16x16', 'scalable'];
-    final categories = ['apps', 'actions', 'devices', 'categories', 'places', 'status', 'emblems', 'mimetypes'];
-    final extensions = ['.svg', '.png', '.xpm'];
-    
-    for (final basePath in systemPaths) {
-      for (final theme in themeSearchOrder) {
-        final themePath = '$basePath/$theme';
-        if (!Directory(themePath).existsSync()) continue;
-
-        for (final size in sizes) {
-          for (final category in categories) {
-            final sizeDir = '$themePath/$size/$category';
-            if (!Directory(sizeDir).existsSync()) continue;
-
-            for (final ext in extensions) {
-              final path = '$sizeDir/$iconName$ext';
-              if (File(path).existsSync()) {
-                return path;
-              }
-            }
 
-            final path = '$sizeDir/$iconName';
-            if (File(path).existsSync()) {
-              return path;
-            }
-          }
+    final physical = (bucket(size) * (scale ?? deviceScale)).ceil();
+    final key = '$iconName@$physical';
+    if (_resolved.containsKey(key)) return _resolved[key];
+    return _resolved[key] = _lookup(iconName, physical);
+  }
+
+  static String? _lookup(String iconName, int physical) {
+    var listed = false;
+    for (final theme in _chain()) {
+      for (final dir in theme.orderFor(physical)) {
+        final String? path;
+        final files = _listings[dir.path];
+        if (files != null) {
+          path = files[iconName];
+        } else if (!listed) {
+          listed = true;
+          path = _list(dir)[iconName];
+        } else {
+          path = _probe(dir, iconName);
         }
+        if (path != null) return path;
       }
     }
 
-    for (final ext in extensions) {
+    for (final ext in ['.svg', '.png', '.xpm', '']) {
       final pixmapPath = '/usr/share/pixmaps/$iconName$ext';
       if (File(pixmapPath).existsSync()) {
         return pixmapPath;
       }
     }
+    return null;
+  }
+
+  static const List<String> _extensions = ['.png', '.svg', '.xpm'];
 
-    final pixmapPath = '/usr/share/pixmaps/$iconName';
-    if (File(pixmapPath).existsSync()) {
-      return pixmapPath;
+  static Map<String, String> _list(_ThemeDir dir) {
+    final files = <String, String>{};
+    final ranks = <String, int>{};
+    try {
+      for (final entity in Directory(dir.path).listSync(followLinks: true)) {
+        final path = entity.path;
+        final dot = path.lastIndexOf('.');
+        final slash = path.lastIndexOf('/');
+        if (dot <= slash) continue;
+        final rank = _extensions.indexOf(path.substring(dot));
+        if (rank < 0) continue;
+        final name = path.substring(slash + 1, dot);
+        if (rank < (ranks[name] ?? _extensions.length)) {
+          ranks[name] = rank;
+          files[name] = path;
+        }
+      }
+    } on FileSystemException {
+      // Listed in index.theme but not installed.
     }
+    return _listings[dir.path] = files;
+  }
 
+  static String? _probe(_ThemeDir dir, String iconName) {
+    for (final ext in _extensions) {
+      final path = '${dir.path}/$iconName$ext';
+      if (File(path).existsSync()) return path;
+    }
     return null;
   }
 
-  static ImageProvider<Object>? getIcon(String iconName) {
-    final path = findIcon(iconName);
+  /// Forgets the theme chain and every resolved icon. Called when the icon
+  /// theme setting changes.
+  static void invalidate() {
+    _resolved.clear();
+    _listings.clear();
+    _themes = null;
+  }
+
+  static ImageProvider<Object>? getIcon(String iconName, {int size = 48, double? scale}) {
+    final path = findIcon(iconName, size: size, scale: scale);
     if (path != null) {
-      return FileImage(File(path));
+      return fileImage(path, size: size, scale: scale);
+    }
+    return null;
+  }
+
+  /// A raster icon decoded to fit its bucketed physical size rather than at
+  /// the file's own resolution. Icons of one bucket share an image cache key.
+  static ImageProvider<Object> fileImage(String path, {int size = 48, double? scale}) {
+    final physical = (bucket(size) * (scale ?? deviceScale)).ceil();
+    return ResizeImage(
+      FileImage(File(path)),
+      width: physical,
+      height: physical,
+      policy: ResizeImagePolicy.fit,
+    );
+  }
+
+  static List<_Theme> _chain() {
+    if (_themes != null) return _themes!;
+    final testing = debugBases != null;
+    if (!testing) _watchThemeSetting();
+
+    final home = Platform.environment['HOME'];
+    final bases = (debugBases ??
+            [
+              '$home/.local/share/icons',
+              '$home/.icons',
+              '/usr/local/share/icons',
+              '/usr/share/icons',
+              '$home/.local/share/flatpak/exports/share/icons',
+              '/var/lib/flatpak/exports/share/icons',
+              '/var/lib/snapd/desktop/icons',
+            ])
+        .where((path) => Directory(path).existsSync())
+        .toList();
+
+    final order = <String>[];
+    void addTheme(String? name) {
+      if (name == null || order.contains(name)) return;
+      order.add(name);
+      final inherits = _readIndexTheme(bases, name)?['Icon Theme']?['Inherits'];
+      for (final parent in inherits?.split(',') ?? const <String>[]) {
+        if (parent.trim().isNotEmpty) addTheme(parent.trim());
+      }
+    }
+
+    // GTK falls back to Adwaita when no theme is configured.
+    addTheme((testing ? debugThemeName : _detectIconTheme()) ?? 'Adwaita');
+    addTheme('hicolor');
+
+    return _themes = [
+      for (final theme in order)
+        _Theme([
+          for (final base in bases)
+            if (Directory('$base/$theme').existsSync())
+              ..._themeDirs('$base/$theme', _readIndexTheme([base], theme)),
+        ]),
+    ].where((theme) => theme.dirs.isNotEmpty).toList();
+  }
+
+  /// Invalidates the caches when either place [_detectIconTheme] reads
+  /// changes. Both watches block until something changes.
+  static void _watchThemeSetting() {
+    if (_watching) return;
+    _watching = true;
+
+    Process.start('gsettings', ['monitor', 'org.gnome.desktop.interface', 'icon-theme'])
+        .then((process) {
+      process.stdout.listen((_) {
+        WakeupCounter.record('gsettings');
+        invalidate();
+      });
+    }, onError: (_) {
+      // gsettings not installed; settings.ini is still watched.
+    });
+
+    final home = Platform.environment['HOME'];
+    final gtkConfig = Directory('$home/.config/gtk-3.0');
+    if (home == null || !gtkConfig.existsSync()) return;
+    gtkConfig
+        .watch()
+        .where((event) => event.path.endsWith('/settings.ini'))
+        .listen((_) => invalidate(), onError: (_) {});
+  }
+
+  /// Directories of a theme from its index.theme, or, for themes without
+  /// one, from names like `48x48/apps`, `48x48@2/apps`, `apps/48` and
+  /// `scalable/apps`.
+  static List<_ThemeDir> _themeDirs(String themePath, Map<String, Map<String, String>>? ini) {
+    final header = ini?['Icon Theme'];
+    if (header != null) {
+      final names = [
+        ...?header['Directories']?.split(','),
+        ...?header['ScaledDirectories']?.split(','),
+      ].map((n) => n.trim()).where((n) => n.isNotEmpty).toSet();
+      return [
+        for (final name in names)
+          if (ini![name] != null)
+            _ThemeDir(
+              '$themePath/$name',
+              int.tryParse(ini[name]!['Size'] ?? '') ?? 0,
+              int.tryParse(ini[name]!['Scale'] ?? '') ?? 1,
+              ini[name]!['Type'] == 'Scalable',
+            ),
+      ];
+    }
+
+    final dirs = <_ThemeDir>[];
+    final sizeName = RegExp(r'^(\d+)(?:x\d+)?(?:@(\d+))?$');
+    for (final outer in Directory(themePath).listSync().whereType<Directory>()) {
+      for (final inner in outer.listSync().whereType<Directory>()) {
+        final segments = [outer.path.split('/').last, inner.path.split('/').last];
+        final scalable = segments.contains('scalable');
+        final match = segments.map(sizeName.firstMatch).whereType<RegExpMatch>().firstOrNull;
+        if (match == null && !scalable) continue;
+        dirs.add(_ThemeDir(
+          inner.path,
+          match != null ? int.parse(match.group(1)!) : 0,
+          int.tryParse(match?.group(2) ?? '') ?? 1,
+          scalable,
+        ));
+      }
+    }
+    return dirs;
+  }
+
+  /// Sections of the first index.theme found for [theme] under [bases].
+  static Map<String, Map<String, String>>? _readIndexTheme(List<String> bases, String theme) {
+    for (final base in bases) {
+      final file = File('$base/$theme/index.theme');
+      if (!file.existsSync()) continue;
+      final sections = <String, Map<String, String>>{};
+      Map<String, String>? current;
+      for (final raw in file.readAsLinesSync()) {
+        final line = raw.trim();
+        if (line.startsWith('[') && line.endsWith(']')) {
+          current = sections[line.substring(1, line.length - 1)] = {};
+        } else if (current != null && line.contains('=') && !line.startsWith('#')) {
+          final eq = line.indexOf('=');
+          current[line.substring(0, eq).trim()] = line.substring(eq + 1).trim();
+        }
+      }
+      return sections;
     }
     return null;
   }
@@ -123,4 +345,4 @@ class IconProvider {
 
     return null;
   }
-}
\ No newline at end of file
+}
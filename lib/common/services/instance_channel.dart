@@ -0,0 +1,21 @@
+import 'package:flutter/services.dart';
+
+/// Receives the arguments of later `vaxp_panel` invocations.
+///
+/// The Linux runner keeps a single resident instance; when the binary is run
+/// again, GApplication forwards the new command line to the running process,
+/// which re-presents its window and calls `activate` on this channel.
+/// Text returned by the handler is printed to the invoking terminal.
+class InstanceChannel {
+  static const MethodChannel _channel = MethodChannel('vaxp_panel/instance');
+
+  static void setActivateHandler(String? Function(List<String> args) onActivate) {
+    _channel.setMethodCallHandler((call) async {
+      if (call.method == 'activate') {
+        final args = (call.arguments as List?)?.cast<String>() ?? const <String>[];
+        return onActivate(args);
+      }
+      return null;
+    });
+  }
+}
@@ -0,0 +1,84 @@
+import 'dart:io';
+import 'dart:math' as math;
+
+/// Per-command launch history, shared with the GTK dock.
+///
+/// Stored as `count<TAB>last<TAB>score<TAB>exec` lines in
+/// `~/.config/dock/launch-history`; `last` is in seconds since the epoch and
+/// `score` halves every [halfLifeDays]. The GTK dock reads the highest
+/// scoring commands ahead into the page cache after login, so launches from
+/// the Flutter dock count towards that too.
+///
+/// Both docks update the file under an exclusive lock on
+/// `launch-history.lock` (an fcntl lock on both sides), re-reading it first
+/// and replacing it with a uniquely named temporary file, so neither loses
+/// the other's launches.
+class LaunchHistory {
+  static const double halfLifeDays = 7;
+
+  static Future<void> _pending = Future.value();
+
+  static File get _file {
+    final env = Platform.environment;
+    final config = (env['XDG_CONFIG_HOME']?.isNotEmpty ?? false)
+        ? env['XDG_CONFIG_HOME']!
+        : '${env['HOME']}/.config';
+    return File('$config/dock/launch-history');
+  }
+
+  /// The history key for an Exec line: field codes and what follows them
+  /// are dropped, as the GTK dock does when it reads desktop files.
+  static String key(String exec) {
+    final pct = exec.indexOf('%');
+    return (pct >= 0 ? exec.substring(0, pct) : exec).trim();
+  }
+
+  /// Counts one launch of [exec]. Calls are serialized.
+  static Future<void> record(String exec) {
+    final k = key(exec);
+    if (k.isEmpty) return _pending;
+    return _pending = _pending.then((_) => _record(k)).catchError((_) {});
+  }
+
+  static Future<void> _record(String exec) async {
+    final file = _file;
+    await file.parent.create(recursive: true);
+    final lock = await File('${file.path}.lock').open(mode: FileMode.append);
+    try {
+      await lock.lock(FileLock.blockingExclusive);
+      await _merge(file, exec);
+    } finally {
+      // Closing the file releases the lock.
+      await lock.close();
+    }
+  }
+
+  static Future<void> _merge(File file, String exec) async {
+    final now = DateTime.now().millisecondsSinceEpoch ~/ 1000;
+    final lines = await file.exists() ? await file.readAsLines() : <String>[];
+
+    var found = false;
+    final out = <String>[];
+    for (final line in lines) {
+      final f = line.split('\t');
+      if (f.length < 4) continue;
+      if (f.sublist(3).join('\t') != exec) {
+        out.add(line);
+        continue;
+      }
+      final count = int.tryParse(f[0]) ?? 0;
+      final last = int.tryParse(f[1]) ?? now;
+      final score = double.tryParse(f[2]) ?? 0;
+      final ageDays = math.max(now - last, 0) / 86400.0;
+      final decayed = score * math.pow(0.5, ageDays / halfLifeDays);
+      out.add('${count + 1}\t$now\t${decayed + 1}\t$exec');
+      found = true;
+    }
+    if (!found) out.add('1\t$now\t1.0\t$exec');
+
+    final stamp = DateTime.now().microsecondsSinceEpoch;
+    final tmp = File('${file.path}.$pid.$stamp');
+    await tmp.writeAsString('${out.join('\n')}\n', flush: true);
+    await tmp.rename(file.path);
+  }
+}
@@ -0,0 +1,44 @@
+import 'package:flutter/services.dart';
+
+/// Talks to the Linux runner about the extra top-level surfaces it can host.
+///
+/// When the shell entry point runs, the runner drives the panel, dock and
+/// launcher windows from a single engine, each as its own Flutter view.
+class SurfaceChannel {
+  static const MethodChannel _channel = MethodChannel('vaxp_panel/surfaces');
+
+  /// Role -> view id, filled in by [createSurfaces]. Empty in single-view mode.
+  static final Map<String, int> viewIds = {};
+
+  static final Map<String, void Function()> _hiddenListeners = {};
+
+  static Future<Map<String, int>> createSurfaces() async {
+    _channel.setMethodCallHandler(_handleCall);
+    final result = await _channel.invokeMapMethod<String, int>('createSurfaces');
+    viewIds
+      ..clear()
+      ..addAll(result ?? const {});
+    return viewIds;
+  }
+
+  static bool hasSurface(String role) => viewIds.containsKey(role);
+
+  /// Calls [listener] when the runner hides the [role] surface by itself,
+  /// e.g. because the window manager closed its window.
+  static void onHidden(String role, void Function() listener) {
+    _hiddenListeners[role] = listener;
+  }
+
+  static Future<void> _handleCall(MethodCall call) async {
+    if (call.method == 'hidden' && call.arguments is Map) {
+      _hiddenListeners[(call.arguments as Map)['role']]?.call();
+    }
+  }
+
+  static Future<void> setVisible(String role, bool visible) async {
+    await _channel.invokeMethod<void>('setSurfaceVisible', {
+      'role': role,
+      'visible': visible,
+    });
+  }
+}
@@ -0,0 +1,31 @@
+/// Counts timer and event wakeups caused by the shell's own Dart code.
+///
+/// Every periodic or event-driven callback calls [record] with a short
+/// source name. [report] gives wakeups per second since the last report,
+/// broken down by source. This only sees the callbacks that label
+/// themselves; the Linux runner counts every main loop wakeup (engine, GTK
+/// and GLib included) by wrapping the GLib poll function. Run
+/// `vaxp_panel --wakeup-stats` against a resident instance to print both,
+/// to check the idle target (no wakeups while nobody touches the desktop).
+class WakeupCounter {
+  static final Map<String, int> _counts = {};
+  static DateTime _since = DateTime.now();
+
+  static void record(String source) {
+    _counts[source] = (_counts[source] ?? 0) + 1;
+  }
+
+  static String report() {
+    final now = DateTime.now();
+    final seconds = now.difference(_since).inMilliseconds / 1000.0;
+    final total = _counts.values.fold<int>(0, (a, b) => a + b);
+    final perSource = _counts.entries
+        .map((e) => '${e.key}=${(e.value / seconds).toStringAsFixed(3)}/s')
+        .join(' ');
+    final line = 'wakeups: ${(total / seconds).toStringAsFixed(3)}/s over '
+        '${seconds.toStringAsFixed(0)} s $perSource';
+    _counts.clear();
+    _since = now;
+    return line;
+  }
+}
@@ -1,6 +1,7 @@
 import 'dart:io';
 import 'package:flutter/material.dart';
 import '../../common/models/desktop_entry.dart';
+import '../../common/services/launch_history.dart';
 
 class AppLauncher {
   static Future<void> launchEntry(DesktopEntry entry, {BuildContext? context}) async {
@@ -13,6 +14,7 @@ class AppLauncher {
     
     try {
       await Process.start('/bin/sh', ['-c', cleaned]);
+      LaunchHistory.record(cmd);
     } catch (e) {
       if (context != null && context.mounted) {
         ScaffoldMessenger.of(context).showSnackBar(
@@ -1,14 +1,34 @@
-/// Multi-window launcher support removed.
+import '../../common/services/surface_channel.dart';
+
+/// Shows the launcher in its own window when the runner hosts one.
 ///
-/// This helper used to create a separate window using `desktop_multi_window`.
-/// The project was reverted to open the launcher inside the main window, so
-/// this function now intentionally does not create a separate window and
-/// returns `false` to indicate the caller should handle opening the launcher
-/// UI in the same engine/process.
+/// Under the shell entry point the launcher is a separate Flutter view driven
+/// by the same engine as the dock. In single-view mode there is no such
+/// surface and the caller opens the launcher inside the current window.
 class LauncherWindow {
-  /// Previously created a new window; now always return false to signal the
-  /// caller to open the launcher in the current window.
+  static bool _visible = false;
+  static bool _listening = false;
+
+  // The window manager can close the launcher without going through Dart.
+  static void _listen() {
+    if (_listening) return;
+    _listening = true;
+    SurfaceChannel.onHidden('launcher', () => _visible = false);
+  }
+
+  /// Toggles the launcher surface. Returns false when no launcher surface
+  /// exists so the caller can fall back to an in-window launcher.
   static Future<bool> toggleLauncherWindow() async {
-    return false;
+    if (!SurfaceChannel.hasSurface('launcher')) return false;
+    _listen();
+    _visible = !_visible;
+    await SurfaceChannel.setVisible('launcher', _visible);
+    return true;
+  }
+
+  static Future<void> hide() async {
+    if (!SurfaceChannel.hasSurface('launcher')) return;
+    _visible = false;
+    await SurfaceChannel.setVisible('launcher', false);
   }
 }
@@ -2,6 +2,7 @@ import 'dart:io';
 import 'package:flutter/material.dart';
 import 'package:flutter_svg/flutter_svg.dart';
 import '../../common/models/desktop_entry.dart';
+import '../../common/services/icon_provider.dart';
 
 class AppGrid extends StatelessWidget {
   final List<DesktopEntry> apps;
@@ -88,7 +89,7 @@ class AppGrid extends StatelessWidget {
                       return CircleAvatar(
                         backgroundColor: Colors.transparent,
                         radius: 28,
-                        backgroundImage: FileImage(File(e.iconPath!)),
+                        backgroundImage: IconProvider.fileImage(e.iconPath!, size: 56),
                       );
                     },
                   ),
@@ -2,6 +2,7 @@ import 'dart:io';
 import 'package:flutter/material.dart';
 import 'package:flutter_svg/flutter_svg.dart';
 import '../../common/models/desktop_entry.dart';
+import '../../common/services/icon_provider.dart';
 import '../../common/widgets/dock_icon.dart';
 import '../services/app_launcher.dart';
 import '../services/launcher_window.dart';
@@ -24,7 +25,7 @@ class _DockBarState extends State<DockBar> {
   @override
   void initState() {
     super.initState();
-    _allAppsFuture = DesktopEntry.loadAll();
+    _allAppsFuture = DesktopEntry.shared();
     _loadPinnedApps();
   }
 
@@ -158,7 +159,7 @@ class _DockBarState extends State<DockBar> {
                           icon = GestureDetector(
                             onSecondaryTapUp: (details) => _showDockIconMenu(context, details, entry.key),
                             child: DockIcon(
-                              iconData: FileImage(File(entry.value.iconPath!)),
+                              iconData: IconProvider.fileImage(entry.value.iconPath!, size: 60),
                               tooltip: entry.value.name,
                               onTap: () => AppLauncher.launchEntry(entry.value, context: context),
                               name: entry.value.name,
@@ -5,9 +5,18 @@ import 'package:flutter_svg/flutter_svg.dart';
 import 'icon_provider.dart';
 import 'icon_loader.dart';
 import 'dock/services/launcher_window.dart';
+import 'common/models/desktop_entry.dart'
+    show applicationDirs, collationKey, desktopFileId, languageNames;
+import 'common/services/instance_channel.dart';
+import 'common/services/launch_history.dart';
+import 'common/services/clock_ticker.dart';
+import 'common/services/frame_stats.dart';
+import 'common/services/wakeup_counter.dart';
+import 'panel/services/system_state.dart';
 
 Future<void> main() async {
   WidgetsFlutterBinding.ensureInitialized();
+  FrameStats.start();
   runApp(const PanelApp());
 }
 
@@ -83,38 +92,33 @@ class DesktopEntry {
   final String? exec;
   late final String? iconPath;
   final bool isSvgIcon;
+  final String sortKey;
 
   DesktopEntry({
     required this.name,
     this.exec,
     this.iconPath,
     this.isSvgIcon = false,
-  });
+  }) : sortKey = collationKey(name);
 
   static Future<List<DesktopEntry>> loadAll() async {
-    // Standard locations for .desktop files
-    final List<String> dirs = [
-      '/usr/share/applications',
-      '/usr/local/share/applications',
-      if (Platform.environment['XDG_DATA_HOME'] != null)
-        '${Platform.environment['XDG_DATA_HOME']!}/applications'
-      else
-        Platform.environment['HOME'] != null
-            ? '${Platform.environment['HOME']!}/.local/share/applications'
-            : '',
-    ];
-
+    // The first file seen for a desktop-file ID owns it, even when it is
+    // hidden, so user overrides mask system entries.
     final Set<String> seen = {};
     final List<DesktopEntry> entries = [];
+    final languages = languageNames();
 
-    for (final dir in dirs) {
+    for (final dir in applicationDirs()) {
       final d = Directory(dir);
       if (!await d.exists()) continue;
-      await for (final file in d.list()) {
+      await for (final file in d.list(recursive: true, followLinks: false)) {
         if (!file.path.endsWith('.desktop')) continue;
+        if (!seen.add(desktopFileId(dir, file.path))) continue;
         try {
           final lines = await File(file.path).readAsLines();
           String? name;
+          String? localName;
+          var localRank = languages.length;
           String? exec;
           String? icon;
           bool inDesktopEntry = false;
@@ -127,10 +131,19 @@ class DesktopEntry {
               inDesktopEntry = true;
               continue;
             }
+            if (inDesktopEntry && l.startsWith('[')) break;
             if (!inDesktopEntry || l.startsWith('#')) continue;
             
-            // Basic fields
+            // Basic fields; Name[xx] for the user's language wins
             if (l.startsWith('Name=')) name = l.substring(5);
+            if (l.startsWith('Name[')) {
+              final close = l.indexOf(']=');
+              final rank = close > 5 ? languages.indexOf(l.substring(5, close)) : -1;
+              if (rank >= 0 && rank < localRank) {
+                localName = l.substring(close + 2);
+                localRank = rank;
+              }
+            }
             if (l.startsWith('Exec=')) exec = l.substring(5);
             if (l.startsWith('Icon=')) icon = l.substring(5);
             
@@ -165,8 +178,8 @@ class DesktopEntry {
             }
           }
           
-          if (name != null && exec != null && shouldDisplay && !seen.contains(name)) {
-            seen.add(name);
+          name = localName ?? name;
+          if (name != null && exec != null && shouldDisplay) {
             if (icon != null) {
               final iconPath = icon.startsWith('/') ? icon : IconProvider.findIcon(icon);
               if (iconPath != null) {
@@ -190,9 +203,7 @@ class DesktopEntry {
         }
       }
     }
-    entries.sort(
-      (a, b) => a.name.toLowerCase().compareTo(b.name.toLowerCase()),
-    );
+    entries.sort((a, b) => a.sortKey.compareTo(b.sortKey));
     return entries;
   }
 
@@ -304,7 +315,7 @@ class AppGrid extends StatelessWidget {
                     return CircleAvatar(
                       backgroundColor: Colors.transparent,
                       radius: 28,
-                      backgroundImage: FileImage(File(e.iconPath!)),
+                      backgroundImage: IconProvider.fileImage(e.iconPath!, size: 56),
                     );
                   },
                 ),
@@ -535,20 +546,15 @@ class PanelHome extends StatefulWidget {
 }
 
 class _PanelHomeState extends State<PanelHome> {
-  String? _backgroundImagePath;
+  // Each piece of panel state is its own notifier, listened to only by the
+  // part of the tree that shows it. Volume, brightness and the radios live
+  // in SystemState.
+  final ValueNotifier<String?> _backgroundImagePath = ValueNotifier(null);
   late Future<List<DesktopEntry>> _allAppsFuture;
-  List<DesktopEntry> _pinned = [];
-  // For time display
-  late DateTime _now;
-  late final ticker = Stream<DateTime>.periodic(const Duration(seconds: 1), (_) => DateTime.now());
-  late final Stream<DateTime> _timeStream;
-  
-  // For volume and brightness control
-  double _volume = 0.5;
-  double _brightness = 0.75;
+  final ValueNotifier<List<DesktopEntry>> _pinned = ValueNotifier(const []);
   
   // Track if app grid dialog is open
-  bool _isAppGridOpen = false;
+  final ValueNotifier<bool> _isAppGridOpen = ValueNotifier(false);
 
   @override
   void initState() {
@@ -557,160 +563,43 @@ class _PanelHomeState extends State<PanelHome> {
     // Load pinned apps
     _loadPinnedApps();
 
-    _now = DateTime.now();
-    _timeStream = ticker;
-    _initializeVolumeAndBrightness();
+    SystemState.instance.ensureStarted();
+    InstanceChannel.setActivateHandler(_onInstanceActivated);
   }
 
-  // Load pinned apps from desktop entries
-  Future<void> _loadPinnedApps() async {
-    final apps = await _allAppsFuture;
-    if (!mounted) return;
-    setState(() {
-      _pinned = apps.take(6).toList();
-    });
-  }
-
-  // Initialize volume and brightness from system
-  Future<void> _initializeVolumeAndBrightness() async {
-    // Get current volume
-    try {
-      final result = await Process.run('pactl', ['get-sink-volume', '@DEFAULT_SINK@']);
-      if (result.exitCode == 0) {
-        final output = result.stdout.toString();
-        // Extract percentage from output like "Volume: front-left: 36864 /  56% / -11.53 dB"
-        final match = RegExp(r'(\d+)%').firstMatch(output);
-        if (match != null) {
-          final percentage = int.parse(match.group(1)!);
-          if (mounted) {
-            setState(() {
-              _volume = percentage / 100.0;
-            });
-          }
-        }
-      }
-    } catch (e) {
-      // Fallback to amixer if pactl fails
-      try {
-        final result = await Process.run('amixer', ['sget', 'Master']);
-        if (result.exitCode == 0) {
-          final output = result.stdout.toString();
-          final match = RegExp(r'\[(\d+)%\]').firstMatch(output);
-          if (match != null) {
-            final percentage = int.parse(match.group(1)!);
-            if (mounted) {
-              setState(() {
-                _volume = percentage / 100.0;
-              });
-            }
-          }
-        }
-      } catch (_) {}
-    }
-
-    // Get current brightness
-    try {
-      final result = await Process.run('brightnessctl', ['get']);
-      if (result.exitCode == 0) {
-        final maxResult = await Process.run('brightnessctl', ['max']);
-        if (maxResult.exitCode == 0) {
-          final current = int.parse(result.stdout.toString().trim());
-          final max = int.parse(maxResult.stdout.toString().trim());
-          if (mounted) {
-            setState(() {
-              _brightness = current / max;
-            });
-          }
-        }
-      }
-    } catch (e) {
-      // Try reading from /sys/class/backlight/ directly
-      try {
-        final backlightDirs = Directory('/sys/class/backlight/').listSync();
-        if (backlightDirs.isNotEmpty) {
-          final dir = backlightDirs.first.path;
-          final brightnessFile = File('$dir/brightness');
-          final maxBrightnessFile = File('$dir/max_brightness');
-          if (await brightnessFile.exists() && await maxBrightnessFile.exists()) {
-            final brightness = int.parse(await brightnessFile.readAsString());
-            final maxBrightness = int.parse(await maxBrightnessFile.readAsString());
-            if (mounted) {
-              setState(() {
-                _brightness = brightness / maxBrightness;
-              });
-            }
-          }
-        }
-      } catch (_) {}
-    }
+  @override
+  void dispose() {
+    _backgroundImagePath.dispose();
+    _pinned.dispose();
+    _isAppGridOpen.dispose();
+    super.dispose();
   }
 
-  // Set system volume
-  Future<void> _setVolume(double volume) async {
-    final volumePercent = (volume * 100).toInt();
-    try {
-      // Try pactl first
-      final result = await Process.run('pactl', ['set-sink-volume', '@DEFAULT_SINK@', '$volumePercent%']);
-      if (result.exitCode == 0) {
-        if (mounted) {
-          setState(() {
-            _volume = volume;
-          });
-        }
-        return;
-      }
-    } catch (e) {
-      // Fallback to amixer
-      try {
-        final result = await Process.run('amixer', ['set', 'Master', '$volumePercent%']);
-        if (result.exitCode == 0 && mounted) {
-          setState(() {
-            _volume = volume;
-          });
-        }
-      } catch (_) {}
+  // Called when `vaxp_panel` is run again while this instance is resident.
+  // Returns the requested reports, which the runner prints to the terminal
+  // that ran the command.
+  String? _onInstanceActivated(List<String> args) {
+    final reports = <String>[
+      if (args.contains('--wakeup-stats')) WakeupCounter.report(),
+      if (args.contains('--frame-stats')) FrameStats.report(),
+    ];
+    if (args.contains('--launcher') && !_isAppGridOpen.value) {
+      _allAppsFuture.then((apps) {
+        if (mounted) _openAppGrid(apps);
+      });
     }
+    return reports.isEmpty ? null : reports.join('\n');
   }
 
-  // Set system brightness
-  Future<void> _setBrightness(double brightness) async {
-    try {
-      // Try brightnessctl first
-      final brightnessPercent = (brightness * 100).toInt();
-      final result = await Process.run('brightnessctl', ['set', '$brightnessPercent%']);
-      if (result.exitCode == 0 && mounted) {
-        setState(() {
-          _brightness = brightness;
-        });
-        return;
-      }
-    } catch (e) {
-      // Fallback to direct file write
-      try {
-        final backlightDirs = Directory('/sys/class/backlight/').listSync();
-        if (backlightDirs.isNotEmpty) {
-          final dir = backlightDirs.first.path;
-          final maxBrightnessFile = File('$dir/max_brightness');
-          if (await maxBrightnessFile.exists()) {
-            final maxBrightness = int.parse(await maxBrightnessFile.readAsString());
-            final targetBrightness = (brightness * maxBrightness).round();
-            final brightnessFile = File('$dir/brightness');
-            await brightnessFile.writeAsString(targetBrightness.toString());
-            if (mounted) {
-              setState(() {
-                _brightness = brightness;
-              });
-            }
-          }
-        }
-      } catch (_) {}
-    }
+  // Load pinned apps from desktop entries
+  Future<void> _loadPinnedApps() async {
+    final apps = await _allAppsFuture;
+    if (!mounted) return;
+    _pinned.value = apps.take(6).toList();
   }
 
   void _openAppGrid(List<DesktopEntry> apps) async {
-    setState(() {
-      _isAppGridOpen = true;
-    });
+    _isAppGridOpen.value = true;
     
     await showDialog<void>(
       context: context,
@@ -730,9 +619,7 @@ class _PanelHomeState extends State<PanelHome> {
       ),
     );
     
-    setState(() {
-      _isAppGridOpen = false;
-    });
+    if (mounted) _isAppGridOpen.value = false;
   }
 
   void _launchEntry(DesktopEntry entry) async {
@@ -743,6 +630,7 @@ class _PanelHomeState extends State<PanelHome> {
     if (cleaned.isEmpty) return;
     try {
       await Process.start('/bin/sh', ['-c', cleaned]);
+      LaunchHistory.record(cmd);
     } catch (e) {
       if (!mounted) return;
       ScaffoldMessenger.of(context).showSnackBar(
@@ -768,9 +656,7 @@ class _PanelHomeState extends State<PanelHome> {
         PopupMenuItem(
           child: const Text('Unpin from dock'),
           onTap: () {
-            setState(() {
-              _pinned.removeAt(index);
-            });
+            _pinned.value = [..._pinned.value]..removeAt(index);
           },
         ),
       ],
@@ -778,43 +664,23 @@ class _PanelHomeState extends State<PanelHome> {
   }
 
   void _pinToDock(DesktopEntry entry) {
-    if (_pinned.length < 10 && !_pinned.any((e) => e.name == entry.name)) {
-      setState(() {
-        _pinned.add(entry);
-      });
+    final pinned = _pinned.value;
+    if (pinned.length < 10 && !pinned.any((e) => e.name == entry.name)) {
+      _pinned.value = [...pinned, entry];
     }
   }
 
   void _showQuickSettings() async {
-    // Query current states for WiFi, airplane mode, Bluetooth
-    bool wifiEnabled = false;
-    bool airplaneMode = false;
-    bool bluetoothEnabled = false;
-    try {
-      final wifi = await Process.run('nmcli', ['radio', 'wifi']);
-      wifiEnabled = wifi.exitCode == 0 && wifi.stdout.toString().trim() == 'enabled';
-    } catch (_) {}
-    try {
-      final radio = await Process.run('nmcli', ['radio', 'all']);
-      if (radio.exitCode == 0) {
-        final out = radio.stdout.toString();
-        airplaneMode = out.contains('disabled');
-      }
-    } catch (_) {}
-    try {
-      final bt = await Process.run('rfkill', ['list', 'bluetooth']);
-      if (bt.exitCode == 0) {
-        final out = bt.stdout.toString();
-        bluetoothEnabled = !out.contains('Soft blocked: yes');
-      }
-    } catch (_) {}
+    // Radios, volume and brightness come from the event-driven cache; each
+    // control below listens only to its own notifier.
+    final state = SystemState.instance;
+    await state.ensureStarted();
+    if (!mounted) return;
 
     Future<void> pickAndSetBackground() async {
       final result = await FilePicker.platform.pickFiles(type: FileType.image);
       if (result != null && result.files.single.path != null) {
-        setState(() {
-          _backgroundImagePath = result.files.single.path;
-        });
+        _backgroundImagePath.value = result.files.single.path;
         // ignore: use_build_context_synchronously
         ScaffoldMessenger.of(context).showSnackBar(const SnackBar(content: Text('Background image set!')));
       }
@@ -841,7 +707,8 @@ class _PanelHomeState extends State<PanelHome> {
               begin: const Offset(0, -1), // Start from top
               end: Offset.zero,
             ).animate(curvedAnimation),
-            child: child,
+            // The sheet repaints on its own while sliders are dragged
+            child: RepaintBoundary(child: child),
           ),
         );
       },
@@ -913,18 +780,24 @@ class _PanelHomeState extends State<PanelHome> {
                                 Row(
                                   children: [
                                     Expanded(
-                                      child: _QuickToggleButton(
-                                        icon: Icons.wifi,
-                                        label: 'Wi-Fi',
-                                        active: wifiEnabled,
-                                        onTap: wifiEnabled ? _disableInternet : _enableInternet,
+                                      child: ValueListenableBuilder<bool>(
+                                        valueListenable: state.wifi,
+                                        builder: (context, wifiEnabled, _) => _QuickToggleButton(
+                                          icon: Icons.wifi,
+                                          label: 'Wi-Fi',
+                                          active: wifiEnabled,
+                                          onTap: wifiEnabled ? _disableInternet : _enableInternet,
+                                        ),
                                       ),
                                     ),
                                     const SizedBox(width: 8),
-                                    _SmallToggleButton(
-                                      icon: Icons.bluetooth,
-                                      active: bluetoothEnabled,
-                                      onTap: _toggleBluetooth,
+                                    ValueListenableBuilder<bool>(
+                                      valueListenable: state.bluetooth,
+                                      builder: (context, bluetoothEnabled, _) => _SmallToggleButton(
+                                        icon: Icons.bluetooth,
+                                        active: bluetoothEnabled,
+                                        onTap: _toggleBluetooth,
+                                      ),
                                     ),
                                   ],
                                 ),
@@ -933,11 +806,14 @@ class _PanelHomeState extends State<PanelHome> {
                                 Row(
                                   children: [
                                     Expanded(
-                                      child: _QuickToggleButton(
-                                        icon: Icons.airplanemode_active,
-                                        label: 'Airplane',
-                                        active: airplaneMode,
-                                        onTap: _toggleAirplaneMode,
+                                      child: ValueListenableBuilder<bool>(
+                                        valueListenable: state.airplane,
+                                        builder: (context, airplaneMode, _) => _QuickToggleButton(
+                                          icon: Icons.airplanemode_active,
+                                          label: 'Airplane',
+                                          active: airplaneMode,
+                                          onTap: _toggleAirplaneMode,
+                                        ),
                                       ),
                                     ),
                                     const SizedBox(width: 8),
@@ -963,10 +839,13 @@ class _PanelHomeState extends State<PanelHome> {
                                   ),
                                   child: Row(
                                     children: [
-                                      Icon(
-                                        _brightness < 0.33 ? Icons.brightness_3 :
-                                        _brightness < 0.66 ? Icons.brightness_6 : Icons.brightness_7,
-                                        size: 24,
+                                      ValueListenableBuilder<double>(
+                                        valueListenable: state.brightness,
+                                        builder: (context, brightness, _) => Icon(
+                                          brightness < 0.33 ? Icons.brightness_3 :
+                                          brightness < 0.66 ? Icons.brightness_6 : Icons.brightness_7,
+                                          size: 24,
+                                        ),
                                       ),
                                       const SizedBox(width: 12),
                                       const Expanded(
@@ -977,11 +856,14 @@ class _PanelHomeState extends State<PanelHome> {
                                       ),
                                       Expanded(
                                         flex: 2,
-                                        child: Slider(
-                                          value: _brightness,
-                                          onChanged: _setBrightness,
-                                          activeColor: Colors.white,
-                                          inactiveColor: Colors.grey.withOpacity(0.3),
+                                        child: ValueListenableBuilder<double>(
+                                          valueListenable: state.brightness,
+                                          builder: (context, brightness, _) => Slider(
+                                            value: brightness,
+                                            onChanged: state.setBrightness,
+                                            activeColor: Colors.white,
+                                            inactiveColor: Colors.grey.withOpacity(0.3),
+                                          ),
                                         ),
                                       ),
                                     ],
@@ -1002,10 +884,13 @@ class _PanelHomeState extends State<PanelHome> {
                                   ),
                                   child: Row(
                                     children: [
-                                      Icon(
-                                        _volume == 0 ? Icons.volume_off :
-                                        _volume < 0.5 ? Icons.volume_down : Icons.volume_up,
-                                        size: 24,
+                                      ValueListenableBuilder<double>(
+                                        valueListenable: state.volume,
+                                        builder: (context, volume, _) => Icon(
+                                          volume == 0 ? Icons.volume_off :
+                                          volume < 0.5 ? Icons.volume_down : Icons.volume_up,
+                                          size: 24,
+                                        ),
                                       ),
                                       const SizedBox(width: 12),
                                       const Expanded(
@@ -1016,11 +901,14 @@ class _PanelHomeState extends State<PanelHome> {
                                       ),
                                       Expanded(
                                         flex: 2,
-                                        child: Slider(
-                                          value: _volume,
-                                          onChanged: _setVolume,
-                                          activeColor: Colors.white,
-                                          inactiveColor: Colors.grey.withOpacity(0.3),
+                                        child: ValueListenableBuilder<double>(
+                                          valueListenable: state.volume,
+                                          builder: (context, volume, _) => Slider(
+                                            value: volume,
+                                            onChanged: state.setVolume,
+                                            activeColor: Colors.white,
+                                            inactiveColor: Colors.grey.withOpacity(0.3),
+                                          ),
                                         ),
                                       ),
                                     ],
@@ -1202,11 +1090,15 @@ class _PanelHomeState extends State<PanelHome> {
         fit: StackFit.expand,
         children: [
           // Background image if set
-          if (_backgroundImagePath != null)
-            Image.file(
-              File(_backgroundImagePath!),
-              fit: BoxFit.cover,
-            ),
+          ValueListenableBuilder<String?>(
+            valueListenable: _backgroundImagePath,
+            builder: (context, path, _) => path == null
+                ? const SizedBox.shrink()
+                : Image.file(
+                    File(path),
+                    fit: BoxFit.cover,
+                  ),
+          ),
           // Main content
           SafeArea(
             child: Column(
@@ -1223,19 +1115,21 @@ class _PanelHomeState extends State<PanelHome> {
                         onPressed: _showQuickSettings,
                       ),
                       Expanded(
-                        child: StreamBuilder<DateTime>(
-                          stream: _timeStream,
-                          initialData: _now,
-                          builder: (context, snapshot) {
-                            final now = snapshot.data ?? DateTime.now();
-                            final timeStr = "${now.hour.toString().padLeft(2, '0')}:${now.minute.toString().padLeft(2, '0')}:${now.second.toString().padLeft(2, '0')}";
-                            return Center(
-                              child: Text(
-                                timeStr,
-                                style: const TextStyle(fontSize: 22, fontWeight: FontWeight.bold),
-                              ),
-                            );
-                          },
+                        child: RepaintBoundary(
+                          child: ValueListenableBuilder<DateTime>(
+                            valueListenable: ClockTicker.instance,
+                            builder: (context, now, _) {
+                              final timeStr = ClockTicker.instance.showSeconds
+                                  ? "${now.hour.toString().padLeft(2, '0')}:${now.minute.toString().padLeft(2, '0')}:${now.second.toString().padLeft(2, '0')}"
+                                  : "${now.hour.toString().padLeft(2, '0')}:${now.minute.toString().padLeft(2, '0')}";
+                              return Center(
+                                child: Text(
+                                  timeStr,
+                                  style: const TextStyle(fontSize: 22, fontWeight: FontWeight.bold),
+                                ),
+                              );
+                            },
+                          ),
                         ),
                       ),
                       const SizedBox(width: 48), // right side empty for symmetry
@@ -1244,144 +1138,16 @@ class _PanelHomeState extends State<PanelHome> {
                 ),
                 Expanded(child: Container()),
                 // Bottom bar: macOS dock style - only show when app grid is closed
-                if (!_isAppGridOpen)
-                  Padding(
-                    padding: const EdgeInsets.only(bottom: 24.0),
-                    child: Row(
-                      mainAxisAlignment: MainAxisAlignment.center,
-                      children: [
-                      // Left side apps
-                      Container(
-                        padding: const EdgeInsets.symmetric(horizontal: 12, vertical: 8),
-                        decoration: BoxDecoration(
-                          color: Colors.black.withOpacity(0.3),
-                          borderRadius: BorderRadius.circular(28),
-                          border: Border.all(
-                            color: Colors.white.withOpacity(0.1),
-                            width: 1,
+                ValueListenableBuilder<bool>(
+                  valueListenable: _isAppGridOpen,
+                  builder: (context, appGridOpen, _) => appGridOpen
+                      ? const SizedBox.shrink()
+                      : RepaintBoundary(
+                          child: ValueListenableBuilder<List<DesktopEntry>>(
+                            valueListenable: _pinned,
+                            builder: (context, pinned, _) => _buildDock(context, pinned),
                           ),
                         ),
-                        child: Row(
-                          mainAxisSize: MainAxisSize.min,
-                          children: [
-                            // App Grid button
-                            _DockIcon(
-                              icon: Icons.apps,
-                              tooltip: 'Show all apps',
-                              onTap: () async {
-                                final handled = await LauncherWindow.toggleLauncherWindow();
-                                if (!handled) {
-                                  final apps = await _allAppsFuture;
-                                  _openAppGrid(apps);
-                                }
-                              },
-                            ),
-                            // Separator
-                            Container(
-                              width: 1,
-                              height: 32,
-                              margin: const EdgeInsets.symmetric(horizontal: 8),
-                              decoration: BoxDecoration(
-                                color: Colors.white.withOpacity(0.2),
-                                borderRadius: BorderRadius.circular(0.5),
-                              ),
-                            ),
-                            // Pinned apps
-                            if (_pinned.isNotEmpty)
-                              ..._pinned.asMap().entries.expand(
-                                (entry) {
-                                  if (entry.value.iconPath != null) {
-                                    Widget icon;
-                                    if (entry.value.isSvgIcon) {
-                                      icon = GestureDetector(
-                                        onSecondaryTapUp: (details) => _showDockIconMenu(context, details, entry.key),
-                                        child: _DockIcon(
-                                          customChild: SvgPicture.file(
-                                            File(entry.value.iconPath!),
-                                            width: 48,
-                                            height: 48,
-                                          ),
-                                          tooltip: entry.value.name,
-                                          onTap: () => _launchEntry(entry.value),
-                                          name: entry.value.name,
-                                        ),
-                                      );
-                                    } else {
-                                      icon = GestureDetector(
-                                        onSecondaryTapUp: (details) => _showDockIconMenu(context, details, entry.key),
-                                        child: _DockIcon(
-                                          iconData: FileImage(File(entry.value.iconPath!)),
-                                          tooltip: entry.value.name,
-                                          onTap: () => _launchEntry(entry.value),
-                                          name: entry.value.name,
-                                        ),
-                                      );
-                                    }
-                                    return [
-                                      icon,
-                                      if (entry.key < _pinned.length - 1) const SizedBox(width: 4),
-                                    ];
-                                  } else {
-                                    return [
-                                      GestureDetector(
-                                        onSecondaryTapUp: (details) => _showDockIconMenu(context, details, entry.key),
-                                        child: _DockIcon(
-                                          icon: Icons.apps,
-                                          tooltip: entry.value.name,
-                                          onTap: () => _launchEntry(entry.value),
-                                          name: entry.value.name,
-                                        ),
-                                      ),
-                                      if (entry.key < _pinned.length - 1) const SizedBox(width: 4),
-                                    ];
-                                  }
-                                },
-                              ),
-                            // Right side utilities separator
-                            Container(
-                              width: 1,
-                              height: 32,
-                              margin: const EdgeInsets.symmetric(horizontal: 8),
-                              decoration: BoxDecoration(
-                                color: Colors.white.withOpacity(0.2),
-                                borderRadius: BorderRadius.circular(0.5),
-                              ),
-                            ),
-                            // Downloads folder
-                            _DockIcon(
-                              icon: Icons.folder,
-                              tooltip: 'Downloads',
-                              onTap: () async {
-                                try {
-                                  await Process.start('/bin/sh', ['-c', 'xdg-open ~/Downloads']);
-                                } catch (e) {
-                                  if (!mounted) return;
-                                  ScaffoldMessenger.of(context).showSnackBar(
-                                    const SnackBar(content: Text('Failed to open Downloads')),
-                                  );
-                                }
-                              },
-                            ),
-                            // Trash
-                            _DockIcon(
-                              icon: Icons.delete_outline,
-                              tooltip: 'Trash',
-                              onTap: () async {
-                                try {
-                                  await Process.start('/bin/sh', ['-c', 'xdg-open trash://']);
-                                } catch (e) {
-                                  if (!mounted) return;
-                                  ScaffoldMessenger.of(context).showSnackBar(
-                                    const SnackBar(content: Text('Failed to open Trash')),
-                                  );
-                                }
-                              },
-                            ),
-                          ],
-                        ),
-                      ),
-                    ],
-                  ),
                 ),
               ],
             ),
@@ -1390,4 +1156,147 @@ class _PanelHomeState extends State<PanelHome> {
       ),
     );
   }
-}
\ No newline at end of file
+
+  // The dock row rebuilds only when the pinned apps change, and repaints
+  // apart from the rest of the panel.
+  Widget _buildDock(BuildContext context, List<DesktopEntry> pinned) {
+    return Padding(
+      padding: const EdgeInsets.only(bottom: 24.0),
+      child: Row(
+        mainAxisAlignment: MainAxisAlignment.center,
+        children: [
+        // Left side apps
+        Container(
+          padding: const EdgeInsets.symmetric(horizontal: 12, vertical: 8),
+          decoration: BoxDecoration(
+            color: Colors.black.withOpacity(0.3),
+            borderRadius: BorderRadius.circular(28),
+            border: Border.all(
+              color: Colors.white.withOpacity(0.1),
+              width: 1,
+            ),
+          ),
+          child: Row(
+            mainAxisSize: MainAxisSize.min,
+            children: [
+              // App Grid button
+              _DockIcon(
+                icon: Icons.apps,
+                tooltip: 'Show all apps',
+                onTap: () async {
+                  final handled = await LauncherWindow.toggleLauncherWindow();
+                  if (!handled) {
+                    final apps = await _allAppsFuture;
+                    _openAppGrid(apps);
+                  }
+                },
+              ),
+              // Separator
+              Container(
+                width: 1,
+                height: 32,
+                margin: const EdgeInsets.symmetric(horizontal: 8),
+                decoration: BoxDecoration(
+                  color: Colors.white.withOpacity(0.2),
+                  borderRadius: BorderRadius.circular(0.5),
+                ),
+              ),
+              // Pinned apps
+              if (pinned.isNotEmpty)
+                ...pinned.asMap().entries.expand(
+                  (entry) {
+                    if (entry.value.iconPath != null) {
+                      Widget icon;
+                      if (entry.value.isSvgIcon) {
+                        icon = GestureDetector(
+                          onSecondaryTapUp: (details) => _showDockIconMenu(context, details, entry.key),
+                          child: _DockIcon(
+                            customChild: SvgPicture.file(
+                              File(entry.value.iconPath!),
+                              width: 48,
+                              height: 48,
+                            ),
+                            tooltip: entry.value.name,
+                            onTap: () => _launchEntry(entry.value),
+                            name: entry.value.name,
+                          ),
+                        );
+                      } else {
+                        icon = GestureDetector(
+                          onSecondaryTapUp: (details) => _showDockIconMenu(context, details, entry.key),
+                          child: _DockIcon(
+                            iconData: IconProvider.fileImage(entry.value.iconPath!, size: 60),
+                            tooltip: entry.value.name,
+                            onTap: () => _launchEntry(entry.value),
+                            name: entry.value.name,
+                          ),
+                        );
+                      }
+                      return [
+                        icon,
+                        if (entry.key < pinned.length - 1) const SizedBox(width: 4),
+                      ];
+                    } else {
+                      return [
+                        GestureDetector(
+                          onSecondaryTapUp: (details) => _showDockIconMenu(context, details, entry.key),
+                          child: _DockIcon(
+                            icon: Icons.apps,
+                            tooltip: entry.value.name,
+                            onTap: () => _launchEntry(entry.value),
+                            name: entry.value.name,
+                          ),
+                        ),
+                        if (entry.key < pinned.length - 1) const SizedBox(width: 4),
+                      ];
+                    }
+                  },
+                ),
+              // Right side utilities separator
+              Container(
+                width: 1,
+                height: 32,
+                margin: const EdgeInsets.symmetric(horizontal: 8),
+                decoration: BoxDecoration(
+                  color: Colors.white.withOpacity(0.2),
+                  borderRadius: BorderRadius.circular(0.5),
+                ),
+              ),
+              // Downloads folder
+              _DockIcon(
+                icon: Icons.folder,
+                tooltip: 'Downloads',
+                onTap: () async {
+                  try {
+                    await Process.start('/bin/sh', ['-c', 'xdg-open ~/Downloads']);
+                  } catch (e) {
+                    if (!mounted) return;
+                    ScaffoldMessenger.of(context).showSnackBar(
+                      const SnackBar(content: Text('Failed to open Downloads')),
+                    );
+                  }
+                },
+              ),
+              // Trash
+              _DockIcon(
+                icon: Icons.delete_outline,
+                tooltip: 'Trash',
+                onTap: () async {
+                  try {
+                    await Process.start('/bin/sh', ['-c', 'xdg-open trash://']);
+                  } catch (e) {
+                    if (!mounted) return;
+                    ScaffoldMessenger.of(context).showSnackBar(
+                      const SnackBar(content: Text('Failed to open Trash')),
+                    );
+                  }
+                },
+              ),
+            ],
+          ),
+        ),
+        ],
+      ),
+    );
+  }
+}
@@ -1,9 +1,14 @@
 import 'dart:io';
 import 'package:flutter/material.dart';
+import '../common/services/clock_ticker.dart';
+import '../common/services/frame_stats.dart';
+import 'services/system_state.dart';
 import 'widgets/clock_display.dart';
 import 'widgets/quick_settings.dart';
 
 void main() {
+  WidgetsFlutterBinding.ensureInitialized();
+  FrameStats.start();
   runApp(const PanelApp());
 }
 
@@ -40,23 +45,23 @@ class PanelHome extends StatefulWidget {
 }
 
 class _PanelHomeState extends State<PanelHome> {
-  String? _backgroundImagePath;
-  DateTime _now = DateTime.now();
-  late final Stream<DateTime> _timeStream;
+  // Only the background layer listens to this; the top bar is not rebuilt.
+  final ValueNotifier<String?> _backgroundImagePath = ValueNotifier(null);
 
   @override
   void initState() {
     super.initState();
-    _timeStream = Stream<DateTime>.periodic(
-      const Duration(seconds: 1),
-      (_) => DateTime.now(),
-    );
+    SystemState.instance.ensureStarted();
+  }
+
+  @override
+  void dispose() {
+    _backgroundImagePath.dispose();
+    super.dispose();
   }
 
   void _updateBackground(String? path) {
-    setState(() {
-      _backgroundImagePath = path;
-    });
+    _backgroundImagePath.value = path;
   }
 
   void _showQuickSettings() {
@@ -78,7 +83,8 @@ class _PanelHomeState extends State<PanelHome> {
               begin: const Offset(0, -1),
               end: Offset.zero,
             ).animate(curvedAnimation),
-            child: child,
+            // The sheet repaints on its own while sliders are dragged
+            child: RepaintBoundary(child: child),
           ),
         );
       },
@@ -97,11 +103,15 @@ class _PanelHomeState extends State<PanelHome> {
       body: Stack(
         fit: StackFit.expand,
         children: [
-          if (_backgroundImagePath != null)
-            Image.file(
-              File(_backgroundImagePath!),
-              fit: BoxFit.cover,
-            ),
+          ValueListenableBuilder<String?>(
+            valueListenable: _backgroundImagePath,
+            builder: (context, path, _) => path == null
+                ? const SizedBox.shrink()
+                : Image.file(
+                    File(path),
+                    fit: BoxFit.cover,
+                  ),
+          ),
           SafeArea(
             child: Column(
               children: [
@@ -116,12 +126,16 @@ class _PanelHomeState extends State<PanelHome> {
                         onPressed: _showQuickSettings,
                       ),
                       Expanded(
-                        child: StreamBuilder<DateTime>(
-                          stream: _timeStream,
-                          initialData: _now,
-                          builder: (context, snapshot) {
-                            return ClockDisplay(time: snapshot.data ?? DateTime.now());
-                          },
+                        child: RepaintBoundary(
+                          child: ValueListenableBuilder<DateTime>(
+                            valueListenable: ClockTicker.instance,
+                            builder: (context, now, _) {
+                              return ClockDisplay(
+                                time: now,
+                                showSeconds: ClockTicker.instance.showSeconds,
+                              );
+                            },
+                          ),
                         ),
                       ),
                       const SizedBox(width: 48),
@@ -0,0 +1,161 @@
+import 'dart:async';
+import 'dart:convert';
+import 'dart:io';
+import 'package:flutter/foundation.dart';
+import '../../common/services/wakeup_counter.dart';
+import 'system_controls.dart';
+
+/// The reads, writes and event monitors [SystemState] uses. Tests replace it
+/// through [SystemState.backend] so nothing touches the real system.
+class SystemBackend {
+  const SystemBackend();
+
+  Future<bool> wifiEnabled() => SystemControls.getWifiStatus();
+  Future<bool> bluetoothEnabled() => SystemControls.getBluetoothStatus();
+  Future<bool> airplaneMode() => SystemControls.getAirplaneModeStatus();
+  Future<double> volume() => SystemControls.getVolume();
+  Future<double> brightness() => SystemControls.getBrightness();
+  Future<void> setVolume(double value) => SystemControls.setVolume(value);
+  Future<void> setBrightness(double value) => SystemControls.setBrightness(value);
+
+  /// Starts a long-running event monitor. Throws if the tool is missing.
+  Future<Process> startMonitor(String cmd, List<String> args) => Process.start(cmd, args);
+}
+
+/// Cached quick-settings state, kept current by system events.
+///
+/// Opening quick settings used to spawn five processes every time. Instead,
+/// the state is read once and refreshed only when `pactl subscribe`,
+/// `nmcli monitor` or `rfkill event` report a change. Those monitors block on
+/// their pipes, so the panel does not wake up while nothing changes.
+/// Brightness has no change events and is only re-read after it is set.
+///
+/// Widgets listen to the individual notifiers, so a slider drag rebuilds
+/// only the slider row that shows it.
+class SystemState {
+  SystemState._();
+
+  static final SystemState instance = SystemState._();
+
+  /// Where state is read from and written to. Set before [ensureStarted].
+  @visibleForTesting
+  SystemBackend backend = const SystemBackend();
+
+  final ValueNotifier<bool> wifi = ValueNotifier(false);
+  final ValueNotifier<bool> bluetooth = ValueNotifier(false);
+  final ValueNotifier<bool> airplane = ValueNotifier(false);
+  final ValueNotifier<double> volume = ValueNotifier(0.5);
+  final ValueNotifier<double> brightness = ValueNotifier(0.75);
+
+  late final _LatestWriter _volumeWriter = _LatestWriter((v) => backend.setVolume(v));
+  late final _LatestWriter _brightnessWriter = _LatestWriter((v) => backend.setBrightness(v));
+
+  final List<Process> _monitors = [];
+  Future<void>? _started;
+
+  /// Loads the initial state and starts the event monitors (once).
+  Future<void> ensureStarted() => _started ??= _start();
+
+  Future<void> _start() async {
+    await Future.wait([_refreshRadios(), _refreshVolume(), _refreshBrightness()]);
+    await _monitor('pactl', ['subscribe'], _refreshVolume,
+        filter: (line) => line.contains('sink'));
+    await _monitor('nmcli', ['monitor'], _refreshRadios);
+    await _monitor('rfkill', ['event'], _refreshRadios);
+  }
+
+  Future<void> _monitor(
+    String cmd,
+    List<String> args,
+    Future<void> Function() refresh, {
+    bool Function(String line)? filter,
+  }) async {
+    try {
+      final process = await backend.startMonitor(cmd, args);
+      _monitors.add(process);
+      // Bursts of lines (e.g. several sink events per key press) are
+      // coalesced into one refresh.
+      Timer? pending;
+      process.stdout
+          .transform(utf8.decoder)
+          .transform(const LineSplitter())
+          .listen((line) {
+        WakeupCounter.record(cmd);
+        if (filter != null && !filter(line)) return;
+        pending?.cancel();
+        pending = Timer(const Duration(milliseconds: 100), refresh);
+      });
+    } catch (_) {
+      // Tool not installed; that part of the state stays as last read.
+    }
+  }
+
+  Future<void> _refreshRadios() async {
+    final results = await Future.wait([
+      backend.wifiEnabled(),
+      backend.bluetoothEnabled(),
+      backend.airplaneMode(),
+    ]);
+    wifi.value = results[0];
+    bluetooth.value = results[1];
+    airplane.value = results[2];
+  }
+
+  Future<void> _refreshVolume() async {
+    // Our own writes echo back as sink events; keep the dragged value.
+    if (_volumeWriter.busy) return;
+    volume.value = await backend.volume();
+  }
+
+  Future<void> _refreshBrightness() async {
+    brightness.value = await backend.brightness();
+  }
+
+  /// Sliders call these on every drag update. The value is published at
+  /// once; only the latest one is written to the system, one write at a time.
+  Future<void> setVolume(double value) {
+    volume.value = value;
+    return _volumeWriter.write(value);
+  }
+
+  Future<void> setBrightness(double value) {
+    brightness.value = value;
+    return _brightnessWriter.write(value);
+  }
+
+  void dispose() {
+    for (final p in _monitors) {
+      p.kill();
+    }
+    _monitors.clear();
+    _started = null;
+  }
+}
+
+/// Serializes writes of a value, dropping all but the newest pending one.
+class _LatestWriter {
+  _LatestWriter(this._apply);
+
+  final Future<void> Function(double) _apply;
+  double? _next;
+  Future<void>? _running;
+
+  bool get busy => _running != null;
+
+  Future<void> write(double value) {
+    _next = value;
+    return _running ??= _drain();
+  }
+
+  Future<void> _drain() async {
+    try {
+      while (_next != null) {
+        final value = _next!;
+        _next = null;
+        await _apply(value);
+      }
+    } finally {
+      _running = null;
+    }
+  }
+}
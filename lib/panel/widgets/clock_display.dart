@@ -2,15 +2,20 @@ import 'package:flutter/material.dart';
 
 class ClockDisplay extends StatelessWidget {
   final DateTime time;
+  final bool showSeconds;
 
   const ClockDisplay({
     super.key,
     required this.time,
+    this.showSeconds = false,
   });
 
   @override
   Widget build(BuildContext context) {
-    final timeStr = "${time.hour.toString().padLeft(2, '0')}:${time.minute.toString().padLeft(2, '0')}:${time.second.toString().padLeft(2, '0')}";
+    String two(int v) => v.toString().padLeft(2, '0');
+    final timeStr = showSeconds
+        ? '${two(time.hour)}:${two(time.minute)}:${two(time.second)}'
+        : '${two(time.hour)}:${two(time.minute)}';
     
     return Center(
       child: Text(
@@ -22,4 +27,4 @@ class ClockDisplay extends StatelessWidget {
       ),
     );
   }
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@ import 'package:flutter/material.dart';
 import 'package:file_picker/file_picker.dart';
 import '../../common/widgets/toggle_buttons.dart';
 import '../services/system_controls.dart';
+import '../services/system_state.dart';
 
 class QuickSettings extends StatefulWidget {
   final Function(String?) onBackgroundChange;
@@ -16,34 +17,15 @@ class QuickSettings extends StatefulWidget {
 }
 
 class _QuickSettingsState extends State<QuickSettings> {
-  bool _wifiEnabled = false;
-  bool _bluetoothEnabled = false;
-  bool _airplaneMode = false;
-  double _volume = 0.5;
-  double _brightness = 0.75;
+  // State comes from the event-driven cache; no processes are spawned here.
+  // Each control listens to its own notifier, so dragging a slider rebuilds
+  // only that slider's row.
+  final SystemState _state = SystemState.instance;
 
   @override
   void initState() {
     super.initState();
-    _loadInitialStates();
-  }
-
-  Future<void> _loadInitialStates() async {
-    final wifi = await SystemControls.getWifiStatus();
-    final bluetooth = await SystemControls.getBluetoothStatus();
-    final airplane = await SystemControls.getAirplaneModeStatus();
-    final volume = await SystemControls.getVolume();
-    final brightness = await SystemControls.getBrightness();
-
-    if (mounted) {
-      setState(() {
-        _wifiEnabled = wifi;
-        _bluetoothEnabled = bluetooth;
-        _airplaneMode = airplane;
-        _volume = volume;
-        _brightness = brightness;
-      });
-    }
+    _state.ensureStarted();
   }
 
   Future<void> _pickAndSetBackground() async {
@@ -158,27 +140,33 @@ class _QuickSettingsState extends State<QuickSettings> {
     return Row(
       children: [
         Expanded(
-          child: QuickToggleButton(
-            icon: Icons.wifi,
-            label: 'Wi-Fi',
-            active: _wifiEnabled,
+          child: ValueListenableBuilder<bool>(
+            valueListenable: _state.wifi,
+            builder: (context, wifiEnabled, _) => QuickToggleButton(
+              icon: Icons.wifi,
+              label: 'Wi-Fi',
+              active: wifiEnabled,
+              onTap: () async {
+                await SystemControls.toggleWifi(!wifiEnabled);
+                _state.wifi.value = !wifiEnabled;
+                if (mounted) Navigator.of(context).pop();
+              },
+            ),
+          ),
+        ),
+        const SizedBox(width: 8),
+        ValueListenableBuilder<bool>(
+          valueListenable: _state.bluetooth,
+          builder: (context, bluetoothEnabled, _) => SmallToggleButton(
+            icon: Icons.bluetooth,
+            active: bluetoothEnabled,
             onTap: () async {
-              await SystemControls.toggleWifi(!_wifiEnabled);
-              setState(() => _wifiEnabled = !_wifiEnabled);
+              await SystemControls.toggleBluetooth(!bluetoothEnabled);
+              _state.bluetooth.value = !bluetoothEnabled;
               if (mounted) Navigator.of(context).pop();
             },
           ),
         ),
-        const SizedBox(width: 8),
-        SmallToggleButton(
-          icon: Icons.bluetooth,
-          active: _bluetoothEnabled,
-          onTap: () async {
-            await SystemControls.toggleBluetooth(!_bluetoothEnabled);
-            setState(() => _bluetoothEnabled = !_bluetoothEnabled);
-            if (mounted) Navigator.of(context).pop();
-          },
-        ),
       ],
     );
   }
@@ -187,15 +175,18 @@ class _QuickSettingsState extends State<QuickSettings> {
     return Row(
       children: [
         Expanded(
-          child: QuickToggleButton(
-            icon: Icons.airplanemode_active,
-            label: 'Airplane',
-            active: _airplaneMode,
-            onTap: () async {
-              await SystemControls.toggleAirplaneMode(!_airplaneMode);
-              setState(() => _airplaneMode = !_airplaneMode);
-              if (mounted) Navigator.of(context).pop();
-            },
+          child: ValueListenableBuilder<bool>(
+            valueListenable: _state.airplane,
+            builder: (context, airplaneMode, _) => QuickToggleButton(
+              icon: Icons.airplanemode_active,
+              label: 'Airplane',
+              active: airplaneMode,
+              onTap: () async {
+                await SystemControls.toggleAirplaneMode(!airplaneMode);
+                _state.airplane.value = !airplaneMode;
+                if (mounted) Navigator.of(context).pop();
+              },
+            ),
           ),
         ),
         const SizedBox(width: 8),
@@ -222,10 +213,13 @@ class _QuickSettingsState extends State<QuickSettings> {
       ),
       child: Row(
         children: [
-          Icon(
-            _brightness < 0.33 ? Icons.brightness_3 :
-            _brightness < 0.66 ? Icons.brightness_6 : Icons.brightness_7,
-            size: 24,
+          ValueListenableBuilder<double>(
+            valueListenable: _state.brightness,
+            builder: (context, brightness, _) => Icon(
+              brightness < 0.33 ? Icons.brightness_3 :
+              brightness < 0.66 ? Icons.brightness_6 : Icons.brightness_7,
+              size: 24,
+            ),
           ),
           const SizedBox(width: 12),
           const Expanded(
@@ -236,14 +230,14 @@ class _QuickSettingsState extends State<QuickSettings> {
           ),
           Expanded(
             flex: 2,
-            child: Slider(
-              value: _brightness,
-              onChanged: (value) async {
-                await SystemControls.setBrightness(value);
-                setState(() => _brightness = value);
-              },
-              activeColor: Colors.white,
-              inactiveColor: Colors.grey.withOpacity(0.3),
+            child: ValueListenableBuilder<double>(
+              valueListenable: _state.brightness,
+              builder: (context, brightness, _) => Slider(
+                value: brightness,
+                onChanged: _state.setBrightness,
+                activeColor: Colors.white,
+                inactiveColor: Colors.grey.withOpacity(0.3),
+              ),
             ),
           ),
         ],
@@ -265,10 +259,13 @@ class _QuickSettingsState extends State<QuickSettings> {
       ),
       child: Row(
         children: [
-          Icon(
-            _volume == 0 ? Icons.volume_off :
-            _volume < 0.5 ? Icons.volume_down : Icons.volume_up,
-            size: 24,
+          ValueListenableBuilder<double>(
+            valueListenable: _state.volume,
+            builder: (context, volume, _) => Icon(
+              volume == 0 ? Icons.volume_off :
+              volume < 0.5 ? Icons.volume_down : Icons.volume_up,
+              size: 24,
+            ),
           ),
           const SizedBox(width: 12),
           const Expanded(
@@ -279,14 +276,14 @@ class _QuickSettingsState extends State<QuickSettings> {
           ),
           Expanded(
             flex: 2,
-            child: Slider(
-              value: _volume,
-              onChanged: (value) async {
-                await SystemControls.setVolume(value);
-                setState(() => _volume = value);
-              },
-              activeColor: Colors.white,
-              inactiveColor: Colors.grey.withOpacity(0.3),
+            child: ValueListenableBuilder<double>(
+              valueListenable: _state.volume,
+              builder: (context, volume, _) => Slider(
+                value: volume,
+                onChanged: _state.setVolume,
+                activeColor: Colors.white,
+                inactiveColor: Colors.grey.withOpacity(0.3),
+              ),
             ),
           ),
         ],
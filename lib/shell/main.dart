@@ -0,0 +1,159 @@
+import 'dart:ui' show FlutterView;
+import 'package:flutter/material.dart';
+import '../common/models/desktop_entry.dart';
+import '../common/services/frame_stats.dart';
+import '../common/services/instance_channel.dart';
+import '../common/services/surface_channel.dart';
+import '../common/services/wakeup_counter.dart';
+import '../dock/main.dart';
+import '../dock/services/app_launcher.dart';
+import '../dock/services/launcher_window.dart';
+import '../dock/widgets/app_grid.dart';
+import '../panel/main.dart';
+
+/// Multi-view entry point: the panel, dock and launcher run as separate
+/// windows driven by one engine, so they share a Dart heap and app list.
+///
+/// Build with `flutter build linux -t lib/shell/main.dart`.
+void main() {
+  WidgetsFlutterBinding.ensureInitialized();
+  FrameStats.start();
+  runWidget(const ShellViews());
+}
+
+/// Handles `vaxp_panel` invocations forwarded to the resident shell.
+///
+/// `--launcher` toggles the launcher surface. `--wakeup-stats` and
+/// `--frame-stats` return their reports, which the runner prints to the
+/// terminal that ran the command.
+class ShellActivation {
+  static void register() => InstanceChannel.setActivateHandler(handle);
+
+  static String? handle(List<String> args) {
+    if (args.contains('--launcher')) LauncherWindow.toggleLauncherWindow();
+    final reports = <String>[
+      if (args.contains('--wakeup-stats')) WakeupCounter.report(),
+      if (args.contains('--frame-stats')) FrameStats.report(),
+    ];
+    return reports.isEmpty ? null : reports.join('\n');
+  }
+}
+
+class ShellViews extends StatefulWidget {
+  const ShellViews({super.key});
+
+  @override
+  State<ShellViews> createState() => _ShellViewsState();
+}
+
+class _ShellViewsState extends State<ShellViews> with WidgetsBindingObserver {
+  // View id -> role; null until the runner has answered createSurfaces.
+  Map<int, String>? _roles;
+
+  static const Set<String> _knownRoles = {'panel', 'dock', 'launcher'};
+
+  @override
+  void initState() {
+    super.initState();
+    WidgetsBinding.instance.addObserver(this);
+    ShellActivation.register();
+    // Warm the shared app list while the views are being created.
+    DesktopEntry.shared();
+    SurfaceChannel.createSurfaces().then((roles) {
+      if (mounted) {
+        setState(() => _roles = {for (final e in roles.entries) e.value: e.key});
+        _checkRoles(_roles!);
+      }
+    });
+  }
+
+  // Runs once, on the runner's reply: every secondary view must have a role
+  // this shell can build, or it stays empty.
+  void _checkRoles(Map<int, String> roles) {
+    final dispatcher = WidgetsBinding.instance.platformDispatcher;
+    final unassigned = [
+      for (final view in dispatcher.views)
+        if (view.viewId != dispatcher.implicitView?.viewId &&
+            !_knownRoles.contains(roles[view.viewId]))
+          '${view.viewId} (${roles[view.viewId] ?? 'none'})',
+    ];
+    assert(unassigned.isEmpty, 'views without a surface role: $unassigned');
+    if (unassigned.isNotEmpty) {
+      debugPrint('shell: views without a surface role: ${unassigned.join(', ')}');
+    }
+  }
+
+  @override
+  void dispose() {
+    WidgetsBinding.instance.removeObserver(this);
+    super.dispose();
+  }
+
+  // Views are added asynchronously by the runner; rebuild when they appear.
+  @override
+  void didChangeMetrics() {
+    setState(() {});
+  }
+
+  // The implicit view always hosts the panel. Other views stay empty until
+  // the runner has told us their role, instead of building a panel each.
+  Widget _surfaceFor(int viewId) {
+    final implicitView = WidgetsBinding.instance.platformDispatcher.implicitView;
+    final role = viewId == implicitView?.viewId ? 'panel' : _roles?[viewId];
+    switch (role) {
+      case 'panel':
+        return const PanelApp();
+      case 'dock':
+        return const DockApp();
+      case 'launcher':
+        return const LauncherApp();
+    }
+    return const SizedBox.shrink();
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final views = WidgetsBinding.instance.platformDispatcher.views;
+    return ViewCollection(
+      views: [
+        for (final FlutterView view in views)
+          View(
+            key: ValueKey(view.viewId),
+            view: view,
+            child: _surfaceFor(view.viewId),
+          ),
+      ],
+    );
+  }
+}
+
+class LauncherApp extends StatelessWidget {
+  const LauncherApp({super.key});
+
+  @override
+  Widget build(BuildContext context) {
+    return MaterialApp(
+      title: 'Launcher',
+      theme: ThemeData(
+        canvasColor: Colors.transparent,
+        scaffoldBackgroundColor: Colors.black38,
+        useMaterial3: true,
+      ),
+      debugShowCheckedModeBanner: false,
+      home: Scaffold(
+        body: FutureBuilder<List<DesktopEntry>>(
+          future: DesktopEntry.shared(),
+          builder: (context, snap) {
+            return AppGrid(
+              apps: snap.data ?? const [],
+              onLaunch: (entry) {
+                LauncherWindow.hide();
+                AppLauncher.launchEntry(entry, context: context);
+              },
+            );
+          },
+        ),
+      ),
+    );
+  }
+}
@@ -10,19 +10,180 @@
 struct _MyApplication {
   GtkApplication parent_instance;
   char** dart_entrypoint_arguments;
+  // Resident window, kept alive (hidden) between invocations.
+  GtkWindow* window;
+  // Forwards arguments of later invocations to the running Dart isolate.
+  FlMethodChannel* instance_channel;
+  // The implicit view created with the engine; drives the panel surface.
+  FlView* view;
+  // Extra top-level windows (dock, launcher) rendered by the same engine,
+  // keyed by surface role.
+  GHashTable* surfaces;
+  FlMethodChannel* surfaces_channel;
 };
 
 G_DEFINE_TYPE(MyApplication, my_application, GTK_TYPE_APPLICATION)
 
+// Wakeup counter: the main context's poll function is wrapped so every
+// return from poll() is counted. This covers GTK, GLib sources and the
+// engine's platform tasks, not just the Dart callbacks WakeupCounter labels.
+// `vaxp_panel --wakeup-stats` prints wakeups per second since the previous
+// report; the D-Bus request carrying that command adds a few of its own.
+static GPollFunc default_poll = nullptr;
+static guint64 wakeups = 0;
+static gint64 wakeups_since = 0;
+
+static gint counting_poll(GPollFD* fds, guint nfds, gint timeout) {
+  gint ret = default_poll(fds, nfds, timeout);
+  wakeups++;
+  return ret;
+}
+
+static void install_wakeup_counter() {
+  GMainContext* context = g_main_context_default();
+  default_poll = g_main_context_get_poll_func(context);
+  g_main_context_set_poll_func(context, counting_poll);
+  wakeups_since = g_get_monotonic_time();
+}
+
+// Returns the main loop wakeups since the previous report and resets them.
+static gchar* wakeup_report() {
+  gint64 now = g_get_monotonic_time();
+  gdouble secs = (now - wakeups_since) / static_cast<gdouble>(G_USEC_PER_SEC);
+  gchar* line = g_strdup_printf("main loop wakeups: %" G_GUINT64_FORMAT " in %.0f s (%.3f/s)",
+                                wakeups, secs, secs > 0 ? wakeups / secs : 0.0);
+  wakeups = 0;
+  wakeups_since = now;
+  return line;
+}
+
 // Called when first Flutter frame received.
 static void first_frame_cb(MyApplication* self, FlView *view)
 {
   gtk_widget_show(gtk_widget_get_toplevel(GTK_WIDGET(view)));
 }
 
+// Hides a surface window the window manager asked to close instead of
+// destroying it, and tells Dart with a `hidden` call on the surfaces channel
+// so its view of which surfaces are shown stays correct.
+static gboolean surface_delete_cb(GtkWidget* window, GdkEvent* event, gpointer user_data) {
+  MyApplication* self = MY_APPLICATION(user_data);
+  gtk_widget_hide(window);
+  g_autoptr(FlValue) args = fl_value_new_map();
+  fl_value_set_string_take(
+      args, "role",
+      fl_value_new_string(static_cast<const gchar*>(g_object_get_data(G_OBJECT(window), "surface-role"))));
+  fl_method_channel_invoke_method(self->surfaces_channel, "hidden", args, nullptr, nullptr, nullptr);
+  return TRUE;
+}
+
+// Creates an undecorated, transparent top-level window hosting a new view of
+// the engine that already drives the main window. Used for the dock and the
+// launcher so every surface shares one Dart heap and raster thread.
+static FlView* create_surface(MyApplication* self, const gchar* role) {
+  FlEngine* engine = fl_view_get_engine(self->view);
+  GtkWindow* window =
+      GTK_WINDOW(gtk_application_window_new(GTK_APPLICATION(self)));
+  GtkWidget* window_widget = GTK_WIDGET(window);
+  gtk_widget_set_app_paintable(window_widget, TRUE);
+  GdkVisual* visual = gdk_screen_get_rgba_visual(gtk_window_get_screen(window));
+  if (visual != nullptr) {
+    gtk_widget_set_visual(window_widget, visual);
+  }
+  gtk_window_set_title(window, role);
+  gtk_window_set_decorated(window, FALSE);
+  gtk_window_set_skip_taskbar_hint(window, TRUE);
+  g_object_set_data_full(G_OBJECT(window), "surface-role", g_strdup(role), g_free);
+  g_signal_connect(window, "delete-event", G_CALLBACK(surface_delete_cb), self);
+
+  if (g_strcmp0(role, "dock") == 0) {
+    gtk_window_set_type_hint(window, GDK_WINDOW_TYPE_HINT_DOCK);
+    gtk_window_set_keep_above(window, TRUE);
+    gtk_window_set_default_size(window, 900, 110);
+  } else {
+    gtk_window_fullscreen(window);
+  }
+
+  FlView* view = fl_view_new_for_engine(engine);
+  GdkRGBA background_color;
+  gdk_rgba_parse(&background_color, "#00000000"); // transparent
+  fl_view_set_background_color(view, &background_color);
+  gtk_widget_show(GTK_WIDGET(view));
+  gtk_container_add(GTK_CONTAINER(window), GTK_WIDGET(view));
+
+  // The launcher stays hidden until Dart asks for it.
+  if (g_strcmp0(role, "launcher") != 0) {
+    g_signal_connect_swapped(view, "first-frame", G_CALLBACK(first_frame_cb), self);
+  }
+  gtk_widget_realize(GTK_WIDGET(view));
+
+  g_hash_table_insert(self->surfaces, g_strdup(role), view);
+  return view;
+}
+
+// Handles calls on the vaxp_panel/surfaces channel.
+//
+// createSurfaces: creates the dock and launcher views (once) and returns a
+//   map of role -> Flutter view id, including the implicit panel view.
+// setSurfaceVisible: {role, visible} shows or hides a surface window.
+//
+// The runner calls `hidden` with {role} when it hid a surface on its own.
+static void surfaces_method_cb(FlMethodChannel* channel, FlMethodCall* method_call, gpointer user_data) {
+  MyApplication* self = MY_APPLICATION(user_data);
+  const gchar* method = fl_method_call_get_name(method_call);
+  FlValue* args = fl_method_call_get_args(method_call);
+
+  if (g_strcmp0(method, "createSurfaces") == 0) {
+    static const gchar* const roles[] = {"dock", "launcher", nullptr};
+    for (const gchar* const* role = roles; *role; ++role) {
+      if (!g_hash_table_contains(self->surfaces, *role)) {
+        create_surface(self, *role);
+      }
+    }
+
+    g_autoptr(FlValue) result = fl_value_new_map();
+    fl_value_set_string_take(result, "panel", fl_value_new_int(fl_view_get_id(self->view)));
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, self->surfaces);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+      fl_value_set_string_take(result, static_cast<const gchar*>(key),
+                               fl_value_new_int(fl_view_get_id(FL_VIEW(value))));
+    }
+    fl_method_call_respond_success(method_call, result, nullptr);
+  } else if (g_strcmp0(method, "setSurfaceVisible") == 0 &&
+             fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
+    FlValue* role = fl_value_lookup_string(args, "role");
+    FlValue* visible = fl_value_lookup_string(args, "visible");
+    FlView* view = role != nullptr && fl_value_get_type(role) == FL_VALUE_TYPE_STRING
+                       ? FL_VIEW(g_hash_table_lookup(self->surfaces, fl_value_get_string(role)))
+                       : nullptr;
+    if (view == nullptr || visible == nullptr || fl_value_get_type(visible) != FL_VALUE_TYPE_BOOL) {
+      fl_method_call_respond_error(method_call, "bad-args", "Unknown surface", nullptr, nullptr);
+      return;
+    }
+    GtkWidget* window = gtk_widget_get_toplevel(GTK_WIDGET(view));
+    if (fl_value_get_bool(visible)) {
+      gtk_window_present(GTK_WINDOW(window));
+    } else {
+      gtk_widget_hide(window);
+    }
+    fl_method_call_respond_success(method_call, nullptr, nullptr);
+  } else {
+    fl_method_call_respond_not_implemented(method_call, nullptr);
+  }
+}
+
 // Implements GApplication::activate.
 static void my_application_activate(GApplication* application) {
   MyApplication* self = MY_APPLICATION(application);
+
+  // Already warm: just bring the existing window back.
+  if (self->window != nullptr) {
+    gtk_window_present(self->window);
+    return;
+  }
+
   GtkWindow* window =
       GTK_WINDOW(gtk_application_window_new(GTK_APPLICATION(application)));
   GtkWidget* window_widget = GTK_WIDGET(window);
@@ -64,10 +225,16 @@ static void my_application_activate(GApplication* application) {
 
   gtk_window_set_default_size(window, 1280, 720);
 
+  // Closing only hides the window so the engine stays resident for the next
+  // invocation.
+  g_signal_connect(window, "delete-event", G_CALLBACK(gtk_widget_hide_on_delete), nullptr);
+  self->window = window;
+
   g_autoptr(FlDartProject) project = fl_dart_project_new();
   fl_dart_project_set_dart_entrypoint_arguments(project, self->dart_entrypoint_arguments);
 
   FlView* view = fl_view_new(project);
+  self->view = view;
   GdkRGBA background_color;
   // Background defaults to black, override it here if necessary, e.g. #00000000 for transparent.
     gdk_rgba_parse(&background_color, "#00000000"); // transparent
@@ -82,33 +249,70 @@ static void my_application_activate(GApplication* application) {
 
   fl_register_plugins(FL_PLUGIN_REGISTRY(view));
 
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  self->instance_channel = fl_method_channel_new(
+      fl_engine_get_binary_messenger(fl_view_get_engine(view)),
+      "vaxp_panel/instance", FL_METHOD_CODEC(codec));
+  self->surfaces_channel = fl_method_channel_new(
+      fl_engine_get_binary_messenger(fl_view_get_engine(view)),
+      "vaxp_panel/surfaces", FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(self->surfaces_channel, surfaces_method_cb,
+                                            self, nullptr);
+
   gtk_widget_grab_focus(GTK_WIDGET(view));
 }
 
-// Implements GApplication::local_command_line.
-static gboolean my_application_local_command_line(GApplication* application, gchar*** arguments, int* exit_status) {
+// Prints the text Dart returned for a forwarded invocation to the terminal
+// that ran it. The remote process exits once the command line is released.
+static void activate_response_cb(GObject* object, GAsyncResult* result, gpointer user_data) {
+  g_autoptr(GApplicationCommandLine) command_line = G_APPLICATION_COMMAND_LINE(user_data);
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(FlMethodResponse) response =
+      fl_method_channel_invoke_method_finish(FL_METHOD_CHANNEL(object), result, &error);
+  FlValue* value = response != nullptr ? fl_method_response_get_result(response, &error) : nullptr;
+  if (value == nullptr && error != nullptr) {
+    g_application_command_line_printerr(command_line, "%s\n", error->message);
+  } else if (value != nullptr && fl_value_get_type(value) == FL_VALUE_TYPE_STRING) {
+    g_application_command_line_print(command_line, "%s\n", fl_value_get_string(value));
+  }
+}
+
+// Implements GApplication::command_line.
+//
+// Runs in the primary instance only. Later invocations are forwarded here by
+// GApplication over D-Bus, so they reuse the running engine instead of
+// booting a new one.
+static int my_application_command_line(GApplication* application, GApplicationCommandLine* command_line) {
   MyApplication* self = MY_APPLICATION(application);
-  // Strip out the first argument as it is the binary name.
-  self->dart_entrypoint_arguments = g_strdupv(*arguments + 1);
+  gint argc = 0;
+  g_auto(GStrv) arguments = g_application_command_line_get_arguments(command_line, &argc);
 
-  g_autoptr(GError) error = nullptr;
-  if (!g_application_register(application, nullptr, &error)) {
-     g_warning("Failed to register: %s", error->message);
-     *exit_status = 1;
-     return TRUE;
+  if (self->window == nullptr) {
+    // Strip out the first argument as it is the binary name.
+    self->dart_entrypoint_arguments = g_strdupv(arguments + 1);
+  } else if (self->instance_channel != nullptr) {
+    if (g_strv_contains(arguments + 1, "--wakeup-stats")) {
+      g_autofree gchar* report = wakeup_report();
+      g_application_command_line_print(command_line, "%s\n", report);
+    }
+    g_autoptr(FlValue) args = fl_value_new_list();
+    for (gint i = 1; i < argc; i++) {
+      fl_value_append_take(args, fl_value_new_string(arguments[i]));
+    }
+    fl_method_channel_invoke_method(self->instance_channel, "activate", args,
+                                    nullptr, activate_response_cb, g_object_ref(command_line));
   }
 
   g_application_activate(application);
-  *exit_status = 0;
-
-  return TRUE;
+  return 0;
 }
 
 // Implements GApplication::startup.
 static void my_application_startup(GApplication* application) {
   //MyApplication* self = MY_APPLICATION(object);
 
-  // Perform any actions required at application startup.
+  // Only the primary instance starts up; count its main loop wakeups.
+  install_wakeup_counter();
 
   G_APPLICATION_CLASS(my_application_parent_class)->startup(application);
 }
@@ -126,18 +330,25 @@ static void my_application_shutdown(GApplication* application) {
 static void my_application_dispose(GObject* object) {
   MyApplication* self = MY_APPLICATION(object);
   g_clear_pointer(&self->dart_entrypoint_arguments, g_strfreev);
+  g_clear_object(&self->instance_channel);
+  g_clear_object(&self->surfaces_channel);
+  g_clear_pointer(&self->surfaces, g_hash_table_unref);
+  self->window = nullptr;
+  self->view = nullptr;
   G_OBJECT_CLASS(my_application_parent_class)->dispose(object);
 }
 
 static void my_application_class_init(MyApplicationClass* klass) {
   G_APPLICATION_CLASS(klass)->activate = my_application_activate;
-  G_APPLICATION_CLASS(klass)->local_command_line = my_application_local_command_line;
+  G_APPLICATION_CLASS(klass)->command_line = my_application_command_line;
   G_APPLICATION_CLASS(klass)->startup = my_application_startup;
   G_APPLICATION_CLASS(klass)->shutdown = my_application_shutdown;
   G_OBJECT_CLASS(klass)->dispose = my_application_dispose;
 }
 
-static void my_application_init(MyApplication* self) {}
+static void my_application_init(MyApplication* self) {
+  self->surfaces = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, nullptr);
+}
 
 MyApplication* my_application_new() {
   // Set the program name to the application ID, which helps various systems
@@ -148,6 +359,6 @@ MyApplication* my_application_new() {
 
   return MY_APPLICATION(g_object_new(my_application_get_type(),
                                      "application-id", APPLICATION_ID,
-                                     "flags", G_APPLICATION_NON_UNIQUE,
+                                     "flags", G_APPLICATION_HANDLES_COMMAND_LINE,
                                      nullptr));
 }
\ No newline at end of file
@@ -7,35 +7,188 @@
  * - "Show apps" button opens a dialog listing .desktop files and allows launching
  *
  * Build: make
- * Requires: GTK+ 3 development libraries (pkg-config gtk+-3.0)
+ * Requires: GTK+ 3 development libraries (pkg-config gtk+-3.0), libwnck-3.0,
+ *           xcomposite, xdamage and xscrnsaver
  */
 
+/* for readahead(2) */
+#define _GNU_SOURCE
+
 #include <gtk/gtk.h>
 #include <gdk/gdk.h>
+#include <gdk/gdkx.h>
+#include <glib-unix.h>
+#include <cairo-xlib.h>
+#include <X11/extensions/Xcomposite.h>
+#include <X11/extensions/Xdamage.h>
+#include <X11/extensions/scrnsaver.h>
+#include <dirent.h>
+#include <elf.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <link.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 /* Acknowledge that libwnck API is not stable */
 #define WNCK_I_KNOW_THIS_IS_UNSTABLE
 #include <libwnck/libwnck.h>
 
-/* Favorites management */
+/*
+ * Application model
+ *
+ * Favorites and launcher entries are fixed-size records stored by value in
+ * GArrays. Their strings live in one GStringChunk arena and are interned, so
+ * values that repeat across entries (icon names like
+ * "application-x-executable", common Exec lines) are stored once. Strings
+ * are only released when the whole model is freed; widgets refer to records
+ * by index or borrow the interned pointers instead of copying them.
+ */
 typedef struct {
-    char *name;
-    char *exec;
-    char *icon;
+    const char *name;
+    const char *exec;
+    const char *icon;
 } FavoriteApp;
 
-static GPtrArray *g_favorites = NULL;
+/* Identity of a .desktop file as last parsed. Package managers keep the
+ * packaged mtime, so the inode change time, inode and size are compared too. */
+typedef struct {
+    gint64 mtime_ns;
+    gint64 ctime_ns;
+    guint64 ino;
+    gint64 size;
+} AppFileStamp;
+
+typedef struct {
+    const char *id;     /* desktop-file ID, e.g. "org.gnome.Terminal.desktop" */
+    const char *name;   /* Name[xx] for the user's language, else Name */
+    const char *exec;
+    const char *icon;
+    const char *path;
+    const char *sort_key;   /* collation key of the label; compare with strcmp */
+    AppFileStamp stamp;
+} AppEntry;
+
+static GStringChunk *g_model_strings = NULL;
+static GHashTable *g_model_intern = NULL;   /* set of interned strings */
+static gsize g_model_string_bytes = 0;
+
+static GArray *g_favorites = NULL;          /* FavoriteApp */
+static GArray *g_app_entries = NULL;        /* AppEntry, launcher cache */
 static GtkWidget *g_dock_box = NULL;  /* The main dock box for favorites */
 static WnckScreen *g_wnck_screen = NULL;
 
 /* launcher window pointer (declared early so functions above can reference it) */
 static GtkWidget *g_launcher_window = NULL;
+/* window preview popover of the hovered favorite, if any */
+static GtkWidget *g_preview = NULL;
 
 /* Forward declarations */
 static void update_favorites_bar(void);
+static void show_last_app_usage(void);
+static gboolean on_dock_button_crossing(GtkWidget *btn, GdkEventCrossing *event, gpointer data);
 static void show_app_context_menu(GtkWidget *btn, GdkEventButton *event);
 static void launch_command(const char *cmd);
+static void record_launch(const char *cmd);
+static void report_launch_latency(void);
+
+/* Copy a string into the model arena without interning (unique values) */
+static const char *model_store(const char *s)
+{
+    if (!s) return NULL;
+    if (!g_model_strings) {
+        g_model_strings = g_string_chunk_new(16 * 1024);
+        g_model_intern = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+    g_model_string_bytes += strlen(s) + 1;
+    return g_string_chunk_insert(g_model_strings, s);
+}
+
+/* Return the arena copy of s, adding it on first use */
+static const char *model_intern(const char *s)
+{
+    if (!s) return NULL;
+    if (g_model_intern) {
+        const char *v = g_hash_table_lookup(g_model_intern, s);
+        if (v) return v;
+    }
+    const char *v = model_store(s);
+    g_hash_table_add(g_model_intern, (gpointer)v);
+    return v;
+}
+
+static void free_model_strings(void)
+{
+    if (g_model_intern) g_hash_table_destroy(g_model_intern);
+    if (g_model_strings) g_string_chunk_free(g_model_strings);
+    g_model_intern = NULL;
+    g_model_strings = NULL;
+    g_model_string_bytes = 0;
+}
+
+/* Log how much memory the app model uses (records + string arena) */
+static void report_model_memory(GLogLevelFlags level)
+{
+    guint napps = g_app_entries ? g_app_entries->len : 0;
+    guint nfavs = g_favorites ? g_favorites->len : 0;
+    guint ninterned = g_model_intern ? g_hash_table_size(g_model_intern) : 0;
+
+    g_log(G_LOG_DOMAIN, level,
+          "model: %u apps (%" G_GSIZE_FORMAT " B), %u favorites (%" G_GSIZE_FORMAT " B), "
+          "%u interned strings, %" G_GSIZE_FORMAT " B in string arena",
+          napps, napps * sizeof(AppEntry), nfavs, nfavs * sizeof(FavoriteApp),
+          ninterned, g_model_string_bytes);
+}
+
+/*
+ * Wakeup counter: the main context's poll function is wrapped so every
+ * return from poll() (i.e. every time the dock wakes up) is counted.
+ * Reported with SIGUSR1 as wakeups per second since the previous report.
+ */
+static GPollFunc g_default_poll = NULL;
+static guint64 g_wakeups = 0;
+static gint64 g_wakeups_since = 0;
+
+static gint counting_poll(GPollFD *fds, guint nfds, gint timeout)
+{
+    gint ret = g_default_poll(fds, nfds, timeout);
+    g_wakeups++;
+    return ret;
+}
+
+static void install_wakeup_counter(void)
+{
+    GMainContext *ctx = g_main_context_default();
+    g_default_poll = g_main_context_get_poll_func(ctx);
+    g_main_context_set_poll_func(ctx, counting_poll);
+    g_wakeups_since = g_get_monotonic_time();
+}
+
+static void report_wakeups(void)
+{
+    gint64 now = g_get_monotonic_time();
+    gdouble secs = (now - g_wakeups_since) / (gdouble)G_USEC_PER_SEC;
+    /* the signal delivery itself is one wakeup */
+    guint64 n = g_wakeups > 0 ? g_wakeups - 1 : 0;
+    g_message("wakeups: %" G_GUINT64_FORMAT " in %.0f s (%.3f/s)", n, secs,
+              secs > 0 ? n / secs : 0.0);
+    g_wakeups = 0;
+    g_wakeups_since = now;
+}
+
+static gboolean on_report_model_signal(gpointer user_data)
+{
+    (void)user_data;
+    report_model_memory(G_LOG_LEVEL_MESSAGE);
+    if (g_default_poll) report_wakeups();
+    report_launch_latency();
+    return G_SOURCE_CONTINUE;
+}
 
 /* A tiny helper to launch a command asynchronously */
 static void
@@ -49,114 +202,176 @@ launch_command(const char *cmd)
     if (cmd == NULL || *cmd == '\0')
         return;
     /* spawn asynchronously, ignore errors here */
-    g_spawn_command_line_async(cmd, NULL);
+    if (g_spawn_command_line_async(cmd, NULL))
+        record_launch(cmd);
 }
 
-/* Button press handler for app buttons */
-static gboolean on_app_button_press(GtkWidget *widget, GdkEventButton *event, gpointer data) {
-    if (event->button == 3) { /* right click */
-        show_app_context_menu(widget, event);
-        return TRUE;
-    } else if (event->button == 1) { /* left click */
-        const char *cmd = g_object_get_data(G_OBJECT(widget), "app-exec");
-        launch_command(cmd);
-        return TRUE;
+/* Return TRUE if the current desktop appears in a ';'-separated list */
+static gboolean desktop_list_contains(const char *list)
+{
+    const char *xd = getenv("XDG_CURRENT_DESKTOP");
+    if (!xd) xd = getenv("DESKTOP_SESSION");
+    if (!xd) xd = "";
+
+    gboolean found = FALSE;
+    gchar **tokens = g_strsplit(list, ";", -1);
+    for (gchar **t = tokens; *t; ++t) {
+        gchar *tok = g_strstrip(*t);
+        if (*tok == '\0') continue;
+        if (g_ascii_strcasecmp(tok, xd) == 0) { found = TRUE; break; }
     }
-    return FALSE;
+    g_strfreev(tokens);
+    return found;
 }
 
-/* Parse a .desktop file to extract Name, Exec and Icon (small parser) */
-typedef struct {
-    char *name;
-    char *exec;
-    char *icon;
-    char *path;
-    gboolean nodisplay;
-    gboolean hidden;
-    char *only_show_in;
-    char *not_show_in;
-} AppEntry;
+static const char *app_entry_label(const AppEntry *ae)
+{
+    return ae->name ? ae->name : (ae->exec ? ae->exec : ae->path);
+}
 
-static AppEntry *parse_desktop_file(const char *filepath)
+/* Rank of locale (len bytes) in the user's language list, 0 = preferred */
+static gint language_rank(const char *locale, gsize len)
 {
-    GError *err = NULL;
-    gchar *content = NULL;
-    if (!g_file_get_contents(filepath, &content, NULL, &err)) {
-        g_clear_error(&err);
-        return NULL;
+    const gchar * const *langs = g_get_language_names();
+    for (gint i = 0; langs[i]; ++i) {
+        if (strlen(langs[i]) == len && strncmp(langs[i], locale, len) == 0)
+            return i;
     }
+    return -1;
+}
 
-    AppEntry *e = g_new0(AppEntry, 1);
-    e->path = g_strdup(filepath);
+/*
+ * Case-insensitive, locale-aware sort key for an entry. Computed once, so
+ * sorting and ordered inserts are plain strcmp calls.
+ */
+static const char *app_entry_sort_key(const AppEntry *ae)
+{
+    gchar *valid = g_utf8_make_valid(app_entry_label(ae), -1);
+    gchar *folded = g_utf8_casefold(valid, -1);
+    gchar *key = g_utf8_collate_key(folded, -1);
+    const char *stored = model_store(key);
+    g_free(key);
+    g_free(folded);
+    g_free(valid);
+    return stored;
+}
 
-    gchar **lines = g_strsplit(content, "\n", -1);
-    for (gchar **l = lines; *l; ++l) {
-        gchar *line = *l;
-        if (line[0] == '#' || line[0] == '\0') continue;
-        if (g_str_has_prefix(line, "Name=")) {
-            g_free(e->name);
-            e->name = g_strdup(line + 5);
+/*
+ * Parse a .desktop file to extract Name, Exec and Icon (small parser).
+ * Only keys of the [Desktop Entry] group are read, and Name[xx] wins over
+ * Name when xx is in the user's language list (the earliest match).
+ * Lines are split in place in the file buffer; only entries that should be
+ * shown in this desktop are copied into the model arena. Returns FALSE for
+ * unreadable, empty, hidden or desktop-filtered entries.
+ */
+static gboolean parse_desktop_file(const char *filepath, AppEntry *out)
+{
+    gchar *content = NULL;
+    if (!g_file_get_contents(filepath, &content, NULL, NULL))
+        return FALSE;
+
+    const char *name = NULL, *exec = NULL, *icon = NULL;
+    const char *local_name = NULL;
+    gint local_rank = -1;
+    const char *only_show_in = NULL, *not_show_in = NULL;
+    gboolean nodisplay = FALSE, hidden = FALSE;
+    gboolean in_entry = FALSE;
+
+    char *line = content;
+    while (line) {
+        char *nl = strchr(line, '\n');
+        if (nl) *nl = '\0';
+
+        if (line[0] == '[') {
+            in_entry = g_str_has_prefix(line, "[Desktop Entry]");
+        } else if (!in_entry || line[0] == '#' || line[0] == '\0') {
+            /* skip */
+        } else if (g_str_has_prefix(line, "Name=")) {
+            name = line + 5;
+        } else if (g_str_has_prefix(line, "Name[")) {
+            char *close = strstr(line, "]=");
+            gint rank = close ? language_rank(line + 5, close - (line + 5)) : -1;
+            if (rank >= 0 && (local_rank < 0 || rank < local_rank)) {
+                local_name = close + 2;
+                local_rank = rank;
+            }
         } else if (g_str_has_prefix(line, "Exec=")) {
-            g_free(e->exec);
             /* strip field codes like %U %u %f etc */
-            gchar *tmp = g_strdup(line + 5);
-            for (char *p = tmp; *p; ++p) {
-                if (*p == '%') { *p = '\0'; break; }
-            }
-            gchar *trim = g_strstrip(tmp);
-            e->exec = g_strdup(trim);
-            g_free(tmp);
+            char *pct = strchr(line + 5, '%');
+            if (pct) *pct = '\0';
+            exec = g_strstrip(line + 5);
         } else if (g_str_has_prefix(line, "Icon=")) {
-            g_free(e->icon);
-            e->icon = g_strdup(line + 5);
+            icon = line + 5;
         } else if (g_str_has_prefix(line, "NoDisplay=")) {
-            gchar *v = g_strdup(line + 10);
-            g_strstrip(v);
-            e->nodisplay = (g_ascii_strcasecmp(v, "true") == 0);
-            g_free(v);
+            nodisplay = (g_ascii_strcasecmp(g_strstrip(line + 10), "true") == 0);
         } else if (g_str_has_prefix(line, "Hidden=")) {
-            gchar *v = g_strdup(line + 7);
-            g_strstrip(v);
-            e->hidden = (g_ascii_strcasecmp(v, "true") == 0);
-            g_free(v);
+            hidden = (g_ascii_strcasecmp(g_strstrip(line + 7), "true") == 0);
         } else if (g_str_has_prefix(line, "OnlyShowIn=")) {
-            g_free(e->only_show_in);
-            e->only_show_in = g_strdup(line + 11);
+            only_show_in = line + 11;
         } else if (g_str_has_prefix(line, "NotShowIn=")) {
-            g_free(e->not_show_in);
-            e->not_show_in = g_strdup(line + 10);
+            not_show_in = line + 10;
         }
+        line = nl ? nl + 1 : NULL;
     }
-    g_strfreev(lines);
-    g_free(content);
 
-    if (!e->name && !e->exec && !e->icon && !e->only_show_in && !e->not_show_in) {
-        g_free(e->name); g_free(e->exec); g_free(e->icon); g_free(e->path);
-        g_free(e->only_show_in); g_free(e->not_show_in);
-        g_free(e);
-        return NULL;
+    /* filter empty, hidden / nodisplay and desktop-specific entries */
+    gboolean add = (name || exec || icon || only_show_in || not_show_in);
+    if (add && (nodisplay || hidden)) add = FALSE;
+    if (add && only_show_in && *only_show_in && !desktop_list_contains(only_show_in)) add = FALSE;
+    if (add && not_show_in && *not_show_in && desktop_list_contains(not_show_in)) add = FALSE;
+
+    if (add) {
+        out->id = NULL;
+        out->name = model_intern(local_name ? local_name : name);
+        out->exec = model_intern(exec);
+        out->icon = model_intern(icon);
+        out->path = model_store(filepath);
+        out->sort_key = app_entry_sort_key(out);
     }
-    return e;
+    g_free(content);
+    return add;
+}
+
+/* Launcher buttons carry their record index + 1 as "app-index" */
+static AppEntry *app_entry_for_widget(GtkWidget *widget)
+{
+    guint idx = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(widget), "app-index"));
+    if (idx == 0 || !g_app_entries || idx > g_app_entries->len) return NULL;
+    return &g_array_index(g_app_entries, AppEntry, idx - 1);
 }
 
-/* Global cached app entries for launcher */
-static GPtrArray *g_app_entries = NULL;
+/* Button press handler for app buttons */
+static gboolean on_app_button_press(GtkWidget *widget, GdkEventButton *event, gpointer data) {
+    if (event->button == 3) { /* right click */
+        show_app_context_menu(widget, event);
+        return TRUE;
+    } else if (event->button == 1) { /* left click */
+        AppEntry *ae = app_entry_for_widget(widget);
+        launch_command(ae ? ae->exec : NULL);
+        return TRUE;
+    }
+    return FALSE;
+}
 
 /* forward declarations */
 static void on_launcher_destroy(GtkWidget *w, gpointer user_data);
 static void on_search_changed(GtkSearchEntry *entry, gpointer user_data);
 static void show_app_launcher(GtkWindow *parent);
 
+typedef struct AppScan AppScan;
+static AppScan *g_app_scan = NULL;    /* desktop-file scan in progress */
+static void app_scan_free(AppScan *s);
+static void replace_app_entries(GArray *scanned);
+
 static void free_app_entries(void)
 {
-    if (!g_app_entries) return;
-    for (guint i = 0; i < g_app_entries->len; ++i) {
-        AppEntry *ae = g_ptr_array_index(g_app_entries, i);
-        g_free(ae->name); g_free(ae->exec); g_free(ae->icon); g_free(ae->path);
-        g_free(ae->only_show_in); g_free(ae->not_show_in);
-        g_free(ae);
+    if (g_app_scan) {
+        app_scan_free(g_app_scan);
+        g_app_scan = NULL;
     }
-    g_ptr_array_free(g_app_entries, TRUE);
+    if (!g_app_entries) return;
+    /* strings belong to the model arena */
+    g_array_free(g_app_entries, TRUE);
     g_app_entries = NULL;
 }
 
@@ -171,7 +386,7 @@ static void save_favorites(void)
     
     GString *data = g_string_new("");
     for (guint i = 0; i < g_favorites->len; ++i) {
-        FavoriteApp *app = g_ptr_array_index(g_favorites, i);
+        FavoriteApp *app = &g_array_index(g_favorites, FavoriteApp, i);
         g_string_append_printf(data, "Name=%s\nExec=%s\nIcon=%s\n\n",
             app->name ? app->name : "",
             app->exec ? app->exec : "",
@@ -188,40 +403,39 @@ static void save_favorites(void)
 static void load_favorites(void)
 {
     if (!g_favorites) {
-        g_favorites = g_ptr_array_new();
+        g_favorites = g_array_new(FALSE, TRUE, sizeof(FavoriteApp));
     }
     
     gchar *config_file = g_build_filename(g_get_user_config_dir(), "dock", "favorites.conf", NULL);
     gchar *content = NULL;
     if (g_file_get_contents(config_file, &content, NULL, NULL)) {
         gchar **lines = g_strsplit(content, "\n", -1);
-        FavoriteApp *current = NULL;
+        FavoriteApp current = { NULL, NULL, NULL };
+        gboolean have_current = FALSE;
         
         for (gchar **l = lines; *l; ++l) {
             gchar *line = g_strstrip(*l);
             if (*line == '\0') {
-                if (current) {
-                    g_ptr_array_add(g_favorites, current);
-                    current = NULL;
+                if (have_current) {
+                    g_array_append_val(g_favorites, current);
+                    memset(&current, 0, sizeof current);
+                    have_current = FALSE;
                 }
                 continue;
             }
             
-            if (!current) {
-                current = g_new0(FavoriteApp, 1);
-            }
-            
+            have_current = TRUE;
             if (g_str_has_prefix(line, "Name=")) {
-                current->name = g_strdup(line + 5);
+                current.name = model_intern(line + 5);
             } else if (g_str_has_prefix(line, "Exec=")) {
-                current->exec = g_strdup(line + 5);
+                current.exec = model_intern(line + 5);
             } else if (g_str_has_prefix(line, "Icon=")) {
-                current->icon = g_strdup(line + 5);
+                current.icon = model_intern(line + 5);
             }
         }
         
-        if (current) {
-            g_ptr_array_add(g_favorites, current);
+        if (have_current) {
+            g_array_append_val(g_favorites, current);
         }
         
         g_strfreev(lines);
@@ -230,121 +444,354 @@ static void load_favorites(void)
     g_free(config_file);
 }
 
-/* Load all .desktop entries into global cache. Safe to call multiple times. */
-static void load_all_desktop_entries(void)
+static void add_application_dir(GPtrArray *dirs, gchar *dir)
 {
-    if (g_app_entries) return; /* already loaded */
-    g_app_entries = g_ptr_array_new();
+    for (guint i = 0; i < dirs->len; ++i) {
+        if (g_strcmp0(g_ptr_array_index(dirs, i), dir) == 0) {
+            g_free(dir);
+            return;
+        }
+    }
+    g_ptr_array_add(dirs, dir);
+}
 
-    const char *dirs[] = { "/usr/share/applications", "/usr/local/share/applications", NULL };
-    gchar *home_apps = g_build_filename(g_get_home_dir(), ".local", "share", "applications", NULL);
+/*
+ * applications/ directories in priority order: XDG_DATA_HOME, then each
+ * XDG_DATA_DIRS entry, then the Flatpak and Snap export directories in case
+ * the session did not add them to XDG_DATA_DIRS.
+ */
+static GPtrArray *application_dirs(void)
+{
+    GPtrArray *dirs = g_ptr_array_new_with_free_func(g_free);
+    add_application_dir(dirs, g_build_filename(g_get_user_data_dir(), "applications", NULL));
+    for (const gchar * const *d = g_get_system_data_dirs(); *d; ++d)
+        add_application_dir(dirs, g_build_filename(*d, "applications", NULL));
+    add_application_dir(dirs, g_build_filename(g_get_user_data_dir(), "flatpak", "exports",
+                                               "share", "applications", NULL));
+    add_application_dir(dirs, g_strdup("/var/lib/flatpak/exports/share/applications"));
+    add_application_dir(dirs, g_strdup("/var/lib/snapd/desktop/applications"));
+    return dirs;
+}
 
-    for (const char **d = dirs; *d; ++d) {
-        GDir *dir = g_dir_open(*d, 0, NULL);
-        if (!dir) continue;
-        const char *name;
-        while ((name = g_dir_read_name(dir))) {
-            if (!g_str_has_suffix(name, ".desktop")) continue;
-            gchar *path = g_build_filename(*d, name, NULL);
-            AppEntry *e = parse_desktop_file(path);
-            g_free(path);
-            if (!e) continue;
-            /* filter hidden / nodisplay and desktop-specific entries */
-            gboolean add = TRUE;
-            if (e->nodisplay || e->hidden) add = FALSE;
-            if (add && e->only_show_in && *e->only_show_in) {
-                const char *xd = getenv("XDG_CURRENT_DESKTOP");
-                if (!xd) xd = getenv("DESKTOP_SESSION");
-                if (!xd) xd = "";
-                gboolean found = FALSE;
-                gchar **tokens = g_strsplit(e->only_show_in, ";", -1);
-                for (gchar **t = tokens; *t; ++t) {
-                    gchar *tok = g_strstrip(*t);
-                    if (*tok == '\0') continue;
-                    if (g_ascii_strcasecmp(tok, xd) == 0) { found = TRUE; break; }
-                }
-                g_strfreev(tokens);
-                if (!found) add = FALSE;
-            }
-            if (add && e->not_show_in && *e->not_show_in) {
-                const char *xd = getenv("XDG_CURRENT_DESKTOP");
-                if (!xd) xd = getenv("DESKTOP_SESSION");
-                if (!xd) xd = "";
-                gchar **tokens = g_strsplit(e->not_show_in, ";", -1);
-                for (gchar **t = tokens; *t; ++t) {
-                    gchar *tok = g_strstrip(*t);
-                    if (*tok == '\0') continue;
-                    if (g_ascii_strcasecmp(tok, xd) == 0) { add = FALSE; break; }
-                }
-                g_strfreev(tokens);
-            }
-            if (add) g_ptr_array_add(g_app_entries, e);
-            else {
-                g_free(e->name); g_free(e->exec); g_free(e->icon); g_free(e->path);
-                g_free(e->only_show_in); g_free(e->not_show_in); g_free(e);
-            }
+/*
+ * Scan the applications/ directories depth-first, a bounded number of
+ * directory entries per step, so startup can spread the scan over idle
+ * callbacks. Open directories wait on a stack. The desktop-file ID is the
+ * path below applications/ with '/' replaced by '-'. The first file seen
+ * for an ID owns it, even when that file is Hidden or NoDisplay, so user
+ * overrides mask system entries. Entries are published in g_app_entries
+ * only once the scan is complete and sorted. A rescan reuses the records of
+ * files whose stamp is unchanged instead of parsing them again, so it adds
+ * nothing to the string arena for them.
+ */
+typedef struct {
+    const char *base;   /* owned by AppScan.dirs */
+    gchar *rel;         /* path below base, NULL for base itself */
+    GDir *dir;
+    int depth;
+} AppScanDir;
+
+struct AppScan {
+    GPtrArray *dirs;    /* application_dirs() */
+    guint next_base;
+    GArray *stack;      /* AppScanDir, innermost last */
+    GHashTable *seen;   /* desktop-file IDs */
+    GArray *entries;    /* AppEntry, unsorted */
+    GHashTable *previous;   /* ID -> AppEntry in g_app_entries, on rescans */
+};
+
+static AppScan *app_scan_new(void)
+{
+    AppScan *s = g_new0(AppScan, 1);
+    s->dirs = application_dirs();
+    s->stack = g_array_new(FALSE, FALSE, sizeof(AppScanDir));
+    s->seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    s->entries = g_array_new(FALSE, FALSE, sizeof(AppEntry));
+    if (g_app_entries) {
+        s->previous = g_hash_table_new(g_str_hash, g_str_equal);
+        for (guint i = 0; i < g_app_entries->len; ++i) {
+            AppEntry *ae = &g_array_index(g_app_entries, AppEntry, i);
+            g_hash_table_insert(s->previous, (gpointer)ae->id, ae);
         }
-        g_dir_close(dir);
     }
+    return s;
+}
 
-    GDir *udir = g_dir_open(home_apps, 0, NULL);
-    if (udir) {
-        const char *name;
-        while ((name = g_dir_read_name(udir))) {
-            if (!g_str_has_suffix(name, ".desktop")) continue;
-            gchar *path = g_build_filename(home_apps, name, NULL);
-            AppEntry *e = parse_desktop_file(path);
-            g_free(path);
-            if (!e) continue;
-            gboolean add = TRUE;
-            if (e->nodisplay || e->hidden) add = FALSE;
-            if (add && e->only_show_in && *e->only_show_in) {
-                const char *xd = getenv("XDG_CURRENT_DESKTOP");
-                if (!xd) xd = getenv("DESKTOP_SESSION");
-                if (!xd) xd = "";
-                gboolean found = FALSE;
-                gchar **tokens = g_strsplit(e->only_show_in, ";", -1);
-                for (gchar **t = tokens; *t; ++t) {
-                    gchar *tok = g_strstrip(*t);
-                    if (*tok == '\0') continue;
-                    if (g_ascii_strcasecmp(tok, xd) == 0) { found = TRUE; break; }
-                }
-                g_strfreev(tokens);
-                if (!found) add = FALSE;
-            }
-            if (add && e->not_show_in && *e->not_show_in) {
-                const char *xd = getenv("XDG_CURRENT_DESKTOP");
-                if (!xd) xd = getenv("DESKTOP_SESSION");
-                if (!xd) xd = "";
-                gchar **tokens = g_strsplit(e->not_show_in, ";", -1);
-                for (gchar **t = tokens; *t; ++t) {
-                    gchar *tok = g_strstrip(*t);
-                    if (*tok == '\0') continue;
-                    if (g_ascii_strcasecmp(tok, xd) == 0) { add = FALSE; break; }
+static void app_scan_free(AppScan *s)
+{
+    for (guint i = 0; i < s->stack->len; ++i) {
+        AppScanDir *d = &g_array_index(s->stack, AppScanDir, i);
+        g_dir_close(d->dir);
+        g_free(d->rel);
+    }
+    g_array_free(s->stack, TRUE);
+    g_ptr_array_free(s->dirs, TRUE);
+    g_hash_table_destroy(s->seen);
+    if (s->previous) g_hash_table_destroy(s->previous);
+    /* strings belong to the model arena */
+    if (s->entries) g_array_free(s->entries, TRUE);
+    g_free(s);
+}
+
+static gboolean app_file_stamp(const char *path, AppFileStamp *out)
+{
+    struct stat st;
+    if (stat(path, &st) != 0) return FALSE;
+    out->mtime_ns = (gint64)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    out->ctime_ns = (gint64)st.st_ctim.tv_sec * 1000000000 + st.st_ctim.tv_nsec;
+    out->ino = st.st_ino;
+    out->size = st.st_size;
+    return TRUE;
+}
+
+static void app_scan_push(AppScan *s, const char *base, const char *rel, int depth)
+{
+    gchar *dirpath = rel ? g_build_filename(base, rel, NULL) : g_strdup(base);
+    GDir *dir = g_dir_open(dirpath, 0, NULL);
+    g_free(dirpath);
+    if (!dir) return;
+    AppScanDir d = { base, g_strdup(rel), dir, depth };
+    g_array_append_val(s->stack, d);
+}
+
+/* Read up to budget directory entries. Returns FALSE once the scan is done. */
+static gboolean app_scan_step(AppScan *s, guint budget)
+{
+    for (; budget > 0; --budget) {
+        if (s->stack->len == 0) {
+            if (s->next_base >= s->dirs->len) return FALSE;
+            app_scan_push(s, g_ptr_array_index(s->dirs, s->next_base++), NULL, 0);
+            continue;
+        }
+
+        AppScanDir *d = &g_array_index(s->stack, AppScanDir, s->stack->len - 1);
+        const char *name = g_dir_read_name(d->dir);
+        if (!name) {
+            g_dir_close(d->dir);
+            g_free(d->rel);
+            g_array_set_size(s->stack, s->stack->len - 1);
+            continue;
+        }
+
+        gchar *rel = d->rel ? g_build_filename(d->rel, name, NULL) : g_strdup(name);
+        gchar *path = g_build_filename(d->base, rel, NULL);
+        if (g_str_has_suffix(name, ".desktop")) {
+            gchar *id = g_strdelimit(g_strdup(rel), G_DIR_SEPARATOR_S, '-');
+            if (g_hash_table_add(s->seen, id)) {
+                const AppEntry *old = s->previous ? g_hash_table_lookup(s->previous, id) : NULL;
+                AppFileStamp stamp = { 0 };
+                gboolean stamped = app_file_stamp(path, &stamp);
+                AppEntry e;
+                if (old && stamped && strcmp(old->path, path) == 0 &&
+                    memcmp(&old->stamp, &stamp, sizeof stamp) == 0) {
+                    e = *old;
+                    g_array_append_val(s->entries, e);
+                } else if (parse_desktop_file(path, &e)) {
+                    e.id = model_store(id);
+                    e.stamp = stamp;
+                    g_array_append_val(s->entries, e);
                 }
-                g_strfreev(tokens);
-            }
-            if (add) g_ptr_array_add(g_app_entries, e);
-            else {
-                g_free(e->name); g_free(e->exec); g_free(e->icon); g_free(e->path);
-                g_free(e->only_show_in); g_free(e->not_show_in); g_free(e);
             }
+        } else if (d->depth < 8 && g_file_test(path, G_FILE_TEST_IS_DIR)) {
+            /* invalidates d */
+            app_scan_push(s, d->base, rel, d->depth + 1);
         }
-        g_dir_close(udir);
+        g_free(path);
+        g_free(rel);
     }
-    g_free(home_apps);
+    return TRUE;
 }
 
-/* Create and show a non-modal application launcher window (grid + search) */
-static void show_app_launcher(GtkWindow *parent)
+static gint compare_app_entries(gconstpointer a, gconstpointer b)
 {
-    load_all_desktop_entries();
+    return strcmp(((const AppEntry *)a)->sort_key, ((const AppEntry *)b)->sort_key);
+}
 
-    if (g_launcher_window) {
-        gtk_window_present(GTK_WINDOW(g_launcher_window));
-        return;
+/* Advance the desktop-file scan (or rescan) by up to budget directory
+ * entries, starting it if nothing is loaded yet. Returns TRUE until the
+ * scan is complete and published. */
+static gboolean load_desktop_entries_step(guint budget)
+{
+    if (g_app_entries && !g_app_scan) return FALSE; /* already loaded */
+    if (!g_app_scan) g_app_scan = app_scan_new();
+    if (app_scan_step(g_app_scan, budget)) return TRUE;
+
+    GArray *scanned = g_app_scan->entries;
+    g_array_sort(scanned, compare_app_entries);
+    g_app_scan->entries = NULL;
+    app_scan_free(g_app_scan);
+    g_app_scan = NULL;
+    if (g_app_entries) replace_app_entries(scanned);
+    else g_app_entries = scanned;
+    report_model_memory(G_LOG_LEVEL_DEBUG);
+    return FALSE;
+}
+
+/* Load all .desktop entries into global cache, sorted by name (rescans
+ * append new entries at the end), finishing a scan already under way.
+ * Safe to call multiple times. */
+static void load_all_desktop_entries(void)
+{
+    while (load_desktop_entries_step(G_MAXUINT))
+        ;
+}
+
+/*
+ * The launcher is one persistent window. It is built hidden in idle time
+ * after startup (the "launcher" phase), shown with gtk_window_present and
+ * hidden again instead of destroyed, so opening it costs a single frame.
+ * Hiding resets the search. The first g_launcher_entries entries have a
+ * button; when a rescan replaces g_app_entries, replace_app_entries keeps
+ * that true and the missing buttons are patched in.
+ */
+static GtkWidget *g_launcher_search = NULL;
+static GtkWidget *g_launcher_flow = NULL;
+static GtkWidget *g_launcher_scrolled = NULL;
+static guint g_launcher_entries = 0;   /* g_app_entries with a button */
+
+static GtkWidget *create_launcher_button(guint i)
+{
+    AppEntry *ae = &g_array_index(g_app_entries, AppEntry, i);
+    const char *label = app_entry_label(ae);
+
+    GtkWidget *btn = gtk_button_new();
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+    GtkWidget *img = NULL;
+    if (ae->icon && *ae->icon) {
+        img = gtk_image_new_from_icon_name(ae->icon, GTK_ICON_SIZE_DIALOG);
+    }
+    if (!img) img = gtk_image_new_from_icon_name("application-x-executable", GTK_ICON_SIZE_DIALOG);
+    gtk_widget_set_size_request(img, 48, 48);
+    gtk_box_pack_start(GTK_BOX(box), img, FALSE, FALSE, 0);
+    GtkWidget *lbl = gtk_label_new(label);
+    gtk_label_set_max_width_chars(GTK_LABEL(lbl), 14);
+    gtk_label_set_ellipsize(GTK_LABEL(lbl), PANGO_ELLIPSIZE_END);
+    gtk_box_pack_start(GTK_BOX(box), lbl, FALSE, FALSE, 0);
+    gtk_container_add(GTK_CONTAINER(btn), box);
+
+    /* record index for filtering, launching and favorites */
+    g_object_set_data(G_OBJECT(btn), "app-index", GUINT_TO_POINTER(i + 1));
+    
+    /* Left click launches, right click shows menu */
+    g_signal_connect(btn, "button-press-event", G_CALLBACK(on_app_button_press), NULL);
+    return btn;
+}
+
+/* Add buttons for up to max entries that do not have one yet; TRUE if
+ * more remain */
+static gboolean sync_launcher_entries(guint max)
+{
+    if (!g_launcher_flow || !g_app_entries) return FALSE;
+    for (guint n = 0; n < max && g_launcher_entries < g_app_entries->len; ++n) {
+        GtkWidget *btn = create_launcher_button(g_launcher_entries++);
+        gtk_widget_show_all(btn);
+        gtk_container_add(GTK_CONTAINER(g_launcher_flow), btn);
+    }
+    return g_launcher_entries < g_app_entries->len;
+}
+
+static gboolean sync_launcher_idle(gpointer user_data)
+{
+    (void)user_data;
+    return sync_launcher_entries(32) ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+/*
+ * Publish a finished rescan. Entries whose file did not change (the rescan
+ * reused their record, so they share its path string) keep their order and
+ * their buttons. Buttons of removed or changed entries are destroyed, and
+ * new or changed entries go to the end, in name order, and get buttons
+ * from sync_launcher_entries.
+ */
+static void replace_app_entries(GArray *scanned)
+{
+    GArray *old = g_app_entries;
+    GHashTable *fresh = g_hash_table_new(g_str_hash, g_str_equal);
+    for (guint i = 0; i < scanned->len; ++i) {
+        AppEntry *ae = &g_array_index(scanned, AppEntry, i);
+        g_hash_table_insert(fresh, (gpointer)ae->id, ae);
+    }
+
+    GArray *merged = g_array_sized_new(FALSE, FALSE, sizeof(AppEntry), scanned->len);
+    guint *remap = g_new0(guint, old->len);   /* old index -> new "app-index" */
+    guint with_buttons = 0;
+    for (guint i = 0; i < old->len; ++i) {
+        AppEntry *o = &g_array_index(old, AppEntry, i);
+        AppEntry *n = g_hash_table_lookup(fresh, o->id);
+        if (!n || n->path != o->path) continue;
+        g_hash_table_remove(fresh, o->id);
+        g_array_append_val(merged, *o);
+        remap[i] = merged->len;
+        if (i < g_launcher_entries) with_buttons++;
+    }
+    for (guint i = 0; i < scanned->len; ++i) {
+        AppEntry *ae = &g_array_index(scanned, AppEntry, i);
+        if (g_hash_table_contains(fresh, ae->id)) g_array_append_val(merged, *ae);
     }
 
+    if (g_launcher_flow) {
+        GList *children = gtk_container_get_children(GTK_CONTAINER(g_launcher_flow));
+        for (GList *it = children; it; it = it->next) {
+            GtkWidget *btn = gtk_bin_get_child(GTK_BIN(it->data));
+            guint idx = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(btn), "app-index"));
+            guint to = idx > 0 && idx <= old->len ? remap[idx - 1] : 0;
+            if (to) g_object_set_data(G_OBJECT(btn), "app-index", GUINT_TO_POINTER(to));
+            else gtk_widget_destroy(GTK_WIDGET(it->data));
+        }
+        g_list_free(children);
+    }
+
+    g_app_entries = merged;
+    g_launcher_entries = with_buttons;
+    g_array_free(old, TRUE);
+    g_array_free(scanned, TRUE);
+    g_free(remap);
+    g_hash_table_destroy(fresh);
+
+    if (!g_launcher_flow) return;
+    if (gtk_widget_get_visible(g_launcher_window)) {
+        sync_launcher_entries(G_MAXUINT);
+        /* filter the new buttons by the current search */
+        on_search_changed(GTK_SEARCH_ENTRY(g_launcher_search), g_launcher_flow);
+    } else if (g_launcher_entries < g_app_entries->len) {
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, sync_launcher_idle, NULL, NULL);
+    }
+}
+
+/* Launcher children keep their entries' order, so patched-in entries are
+ * inserted in place */
+static gint compare_launcher_children(GtkFlowBoxChild *a, GtkFlowBoxChild *b, gpointer user_data)
+{
+    (void)user_data;
+    AppEntry *ea = app_entry_for_widget(gtk_bin_get_child(GTK_BIN(a)));
+    AppEntry *eb = app_entry_for_widget(gtk_bin_get_child(GTK_BIN(b)));
+    return g_strcmp0(ea ? ea->sort_key : NULL, eb ? eb->sort_key : NULL);
+}
+
+/* Clear the search and scroll back to the top whenever the launcher hides */
+static void on_launcher_hide(GtkWidget *w, gpointer user_data)
+{
+    (void)user_data;
+    if (gtk_widget_in_destruction(w)) return;
+    /* an empty search entry emits search-changed at once, showing all */
+    gtk_entry_set_text(GTK_ENTRY(g_launcher_search), "");
+    GtkAdjustment *vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(g_launcher_scrolled));
+    gtk_adjustment_set_value(vadj, gtk_adjustment_get_lower(vadj));
+}
+
+static gboolean on_launcher_key_press(GtkWidget *w, GdkEventKey *event, gpointer user_data)
+{
+    (void)user_data;
+    if (event->keyval != GDK_KEY_Escape) return FALSE;
+    gtk_widget_hide(w);
+    return TRUE;
+}
+
+/* Build the launcher window (grid + search) without showing it */
+static void build_app_launcher(GtkWindow *parent)
+{
+    if (g_launcher_window) return;
+
     GdkScreen *screen = gdk_screen_get_default();
     GdkVisual *visual = gdk_screen_get_rgba_visual(screen);
 
@@ -370,59 +817,43 @@ static void show_app_launcher(GtkWindow *parent)
     gtk_container_set_border_width(GTK_CONTAINER(vbox), 8);
     gtk_container_add(GTK_CONTAINER(g_launcher_window), vbox);
 
-    GtkWidget *search = gtk_search_entry_new();
-    gtk_box_pack_start(GTK_BOX(vbox), search, FALSE, FALSE, 0);
+    g_launcher_search = gtk_search_entry_new();
+    gtk_box_pack_start(GTK_BOX(vbox), g_launcher_search, FALSE, FALSE, 0);
 
-    GtkWidget *scrolled = gtk_scrolled_window_new(NULL, NULL);
-    gtk_widget_set_vexpand(scrolled, TRUE);
-    gtk_box_pack_start(GTK_BOX(vbox), scrolled, TRUE, TRUE, 0);
-
-    GtkWidget *flow = gtk_flow_box_new();
-    gtk_flow_box_set_max_children_per_line(GTK_FLOW_BOX(flow), 6);
-    gtk_flow_box_set_selection_mode(GTK_FLOW_BOX(flow), GTK_SELECTION_NONE);
-    gtk_container_add(GTK_CONTAINER(scrolled), flow);
-
-    /* populate */
-    for (guint i = 0; i < g_app_entries->len; ++i) {
-        AppEntry *ae = g_ptr_array_index(g_app_entries, i);
-        const char *label = ae->name ? ae->name : (ae->exec ? ae->exec : ae->path);
-
-        GtkWidget *btn = gtk_button_new();
-        GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
-        GtkWidget *img = NULL;
-        if (ae->icon && *ae->icon) {
-            img = gtk_image_new_from_icon_name(ae->icon, GTK_ICON_SIZE_DIALOG);
-        }
-        if (!img) img = gtk_image_new_from_icon_name("application-x-executable", GTK_ICON_SIZE_DIALOG);
-        gtk_widget_set_size_request(img, 48, 48);
-        gtk_box_pack_start(GTK_BOX(box), img, FALSE, FALSE, 0);
-        GtkWidget *lbl = gtk_label_new(label);
-        gtk_label_set_max_width_chars(GTK_LABEL(lbl), 14);
-        gtk_label_set_ellipsize(GTK_LABEL(lbl), PANGO_ELLIPSIZE_END);
-        gtk_box_pack_start(GTK_BOX(box), lbl, FALSE, FALSE, 0);
-        gtk_container_add(GTK_CONTAINER(btn), box);
-
-        /* store app data for filtering, launching and favorites */
-        g_object_set_data_full(G_OBJECT(btn), "app-name", g_strdup(label), g_free);
-        g_object_set_data_full(G_OBJECT(btn), "app-exec", g_strdup(ae->exec ? ae->exec : ""), g_free);
-        g_object_set_data_full(G_OBJECT(btn), "app-icon", g_strdup(ae->icon ? ae->icon : ""), g_free);
-        
-        /* Left click launches, right click shows menu */
-        g_signal_connect(btn, "button-press-event", G_CALLBACK(on_app_button_press), NULL);
+    g_launcher_scrolled = gtk_scrolled_window_new(NULL, NULL);
+    gtk_widget_set_vexpand(g_launcher_scrolled, TRUE);
+    gtk_box_pack_start(GTK_BOX(vbox), g_launcher_scrolled, TRUE, TRUE, 0);
 
-        gtk_container_add(GTK_CONTAINER(flow), btn);
-    }
+    g_launcher_flow = gtk_flow_box_new();
+    gtk_flow_box_set_max_children_per_line(GTK_FLOW_BOX(g_launcher_flow), 6);
+    gtk_flow_box_set_selection_mode(GTK_FLOW_BOX(g_launcher_flow), GTK_SELECTION_NONE);
+    gtk_flow_box_set_sort_func(GTK_FLOW_BOX(g_launcher_flow), compare_launcher_children, NULL, NULL);
+    gtk_container_add(GTK_CONTAINER(g_launcher_scrolled), g_launcher_flow);
+    g_launcher_entries = 0;
 
-    /* search handler: filters children by the app-name data */
-    g_signal_connect(search, "search-changed", G_CALLBACK(on_search_changed), flow);
+    /* search handler: filters children by their record's name */
+    g_signal_connect(g_launcher_search, "search-changed", G_CALLBACK(on_search_changed), g_launcher_flow);
 
     g_signal_connect(g_launcher_window, "destroy", G_CALLBACK(on_launcher_destroy), NULL);
+    g_signal_connect(g_launcher_window, "delete-event", G_CALLBACK(gtk_widget_hide_on_delete), NULL);
+    g_signal_connect(g_launcher_window, "hide", G_CALLBACK(on_launcher_hide), NULL);
+    g_signal_connect(g_launcher_window, "key-press-event", G_CALLBACK(on_launcher_key_press), NULL);
 
     /* Add class to apply transparent background CSS */
     GtkStyleContext *ctx = gtk_widget_get_style_context(g_launcher_window);
     gtk_style_context_add_class(ctx, "launcher-window");
 
-    gtk_widget_show_all(g_launcher_window);
+    gtk_widget_show_all(vbox);
+    gtk_widget_realize(g_launcher_window);
+}
+
+/* Show the launcher, building it or patching in new entries if needed */
+static void show_app_launcher(GtkWindow *parent)
+{
+    load_all_desktop_entries();
+    build_app_launcher(parent);
+    sync_launcher_entries(G_MAXUINT);
+    gtk_window_present(GTK_WINDOW(g_launcher_window));
 }
 
 /* Called when the launcher window is destroyed */
@@ -430,20 +861,101 @@ static void on_launcher_destroy(GtkWidget *w, gpointer user_data)
 {
     (void)user_data;
     g_launcher_window = NULL;
+    g_launcher_search = NULL;
+    g_launcher_flow = NULL;
+    g_launcher_scrolled = NULL;
+    g_launcher_entries = 0;
+}
+
+/*
+ * The application directories are watched once the index is loaded. A
+ * burst of changes (a package install) restarts a one-second timer, then
+ * the directories are rescanned in idle slices like the startup scan and
+ * the result replaces g_app_entries. Only the top-level directories are
+ * watched; changes in subdirectories are picked up by the next rescan.
+ */
+static GPtrArray *g_app_dir_monitors = NULL;
+static guint g_app_rescan_id = 0;
+
+static gboolean run_applications_rescan(gpointer user_data)
+{
+    (void)user_data;
+    if (load_desktop_entries_step(64)) return G_SOURCE_CONTINUE;
+    g_app_rescan_id = 0;
+    return G_SOURCE_REMOVE;
 }
 
-/* Callback for removing flash effect */
-static gboolean remove_flash_class(gpointer data)
+static gboolean start_applications_rescan(gpointer user_data)
 {
-    GtkWidget *widget = GTK_WIDGET(data);
-    if (!GTK_IS_WIDGET(widget)) return G_SOURCE_REMOVE;
-    
-    GtkStyleContext *ctx = gtk_widget_get_style_context(widget);
-    if (ctx) {
-        gtk_style_context_remove_class(ctx, "flash");
+    (void)user_data;
+    if (!g_app_scan) g_app_scan = app_scan_new();
+    g_app_rescan_id = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, run_applications_rescan, NULL, NULL);
+    return G_SOURCE_REMOVE;
+}
+
+static void on_applications_changed(GFileMonitor *monitor, GFile *file, GFile *other,
+                                    GFileMonitorEvent event, gpointer user_data)
+{
+    (void)monitor; (void)file; (void)other; (void)user_data;
+    if (event != G_FILE_MONITOR_EVENT_CREATED && event != G_FILE_MONITOR_EVENT_DELETED &&
+        event != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT)
+        return;
+    /* a rescan in progress may already have passed the changed file */
+    if (g_app_scan && g_app_entries) {
+        app_scan_free(g_app_scan);
+        g_app_scan = NULL;
+    }
+    if (g_app_rescan_id) g_source_remove(g_app_rescan_id);
+    g_app_rescan_id = g_timeout_add_seconds(1, start_applications_rescan, NULL);
+}
+
+static void watch_application_dirs(void)
+{
+    if (g_app_dir_monitors) return;
+    g_app_dir_monitors = g_ptr_array_new_with_free_func(g_object_unref);
+    GPtrArray *dirs = application_dirs();
+    for (guint i = 0; i < dirs->len; ++i) {
+        GFile *dir = g_file_new_for_path(g_ptr_array_index(dirs, i));
+        GFileMonitor *monitor = g_file_monitor_directory(dir, G_FILE_MONITOR_NONE, NULL, NULL);
+        g_object_unref(dir);
+        if (!monitor) continue;
+        g_signal_connect(monitor, "changed", G_CALLBACK(on_applications_changed), NULL);
+        g_ptr_array_add(g_app_dir_monitors, monitor);
+    }
+    g_ptr_array_free(dirs, TRUE);
+}
+
+static void free_application_watch(void)
+{
+    if (g_app_rescan_id) {
+        g_source_remove(g_app_rescan_id);
+        g_app_rescan_id = 0;
+    }
+    if (g_app_dir_monitors) {
+        g_ptr_array_free(g_app_dir_monitors, TRUE);
+        g_app_dir_monitors = NULL;
+    }
+}
+
+/*
+ * Flash effect. All flashing widgets share one 500 ms timer, restarted by
+ * each new flash, so a burst of flashes costs a single wakeup, every flash
+ * lasts at least 500 ms, and the dock arms no timers at all while idle.
+ */
+static GPtrArray *g_flashing = NULL;
+static guint g_flash_timer_id = 0;
+
+static gboolean remove_flash_classes(gpointer data)
+{
+    (void)data;
+    for (guint i = 0; i < g_flashing->len; ++i) {
+        GtkWidget *widget = g_ptr_array_index(g_flashing, i);
+        gtk_style_context_remove_class(gtk_widget_get_style_context(widget), "flash");
         /* Ensure widget is redrawn */
         gtk_widget_queue_draw(widget);
     }
+    g_ptr_array_set_size(g_flashing, 0);
+    g_flash_timer_id = 0;
     return G_SOURCE_REMOVE;
 }
 
@@ -451,14 +963,16 @@ static gboolean remove_flash_class(gpointer data)
 static void flash_widget(GtkWidget *widget)
 {
     if (!GTK_IS_WIDGET(widget)) return;
+    if (!g_flashing) g_flashing = g_ptr_array_new_with_free_func(g_object_unref);
     
     GtkStyleContext *context = gtk_widget_get_style_context(widget);
-    if (context) {
-        gtk_style_context_add_class(context, "flash");
-        /* Ensure widget is redrawn */
-        gtk_widget_queue_draw(widget);
-        g_timeout_add(500, remove_flash_class, widget);
-    }
+    gtk_style_context_add_class(context, "flash");
+    /* Ensure widget is redrawn */
+    gtk_widget_queue_draw(widget);
+    g_ptr_array_add(g_flashing, g_object_ref(widget));
+    if (g_flash_timer_id)
+        g_source_remove(g_flash_timer_id);
+    g_flash_timer_id = g_timeout_add(500, remove_flash_classes, NULL);
 }
 
 static void remove_from_favorites(const char *exec)
@@ -466,13 +980,9 @@ static void remove_from_favorites(const char *exec)
     if (!g_favorites) return;
     
     for (guint i = 0; i < g_favorites->len; ++i) {
-        FavoriteApp *app = g_ptr_array_index(g_favorites, i);
+        FavoriteApp *app = &g_array_index(g_favorites, FavoriteApp, i);
         if (g_strcmp0(app->exec, exec) == 0) {
-            g_free(app->name);
-            g_free(app->exec);
-            g_free(app->icon);
-            g_free(app);
-            g_ptr_array_remove_index(g_favorites, i);
+            g_array_remove_index(g_favorites, i);
             break;
         }
     }
@@ -484,27 +994,28 @@ static void remove_from_favorites(const char *exec)
 static void add_to_favorites(GtkWidget *menuitem, gpointer user_data)
 {
     GtkWidget *btn = GTK_WIDGET(user_data);
-    const char *name = g_object_get_data(G_OBJECT(btn), "app-name");
-    const char *exec = g_object_get_data(G_OBJECT(btn), "app-exec");
-    const char *icon = g_object_get_data(G_OBJECT(btn), "app-icon");
+    AppEntry *ae = app_entry_for_widget(btn);
+    if (!ae) return;
+    const char *exec = ae->exec ? ae->exec : "";
     
     if (!g_favorites) {
-        g_favorites = g_ptr_array_new();
+        g_favorites = g_array_new(FALSE, TRUE, sizeof(FavoriteApp));
     }
     
     /* Check if already in favorites */
     for (guint i = 0; i < g_favorites->len; ++i) {
-        FavoriteApp *app = g_ptr_array_index(g_favorites, i);
+        FavoriteApp *app = &g_array_index(g_favorites, FavoriteApp, i);
         if (g_strcmp0(app->exec, exec) == 0) {
             return; /* Already exists */
         }
     }
     
-    FavoriteApp *fav = g_new0(FavoriteApp, 1);
-    fav->name = g_strdup(name);
-    fav->exec = g_strdup(exec);
-    fav->icon = g_strdup(icon);
-    g_ptr_array_add(g_favorites, fav);
+    FavoriteApp fav = {
+        model_intern(app_entry_label(ae)),
+        model_intern(exec),
+        model_intern(ae->icon ? ae->icon : ""),
+    };
+    g_array_append_val(g_favorites, fav);
     
     save_favorites();
     update_favorites_bar();
@@ -517,9 +1028,9 @@ static void add_to_favorites(GtkWidget *menuitem, gpointer user_data)
     }
     g_list_free(children);
     
-    /* Close the launcher window */
+    /* Close the launcher window; it is kept for the next open */
     if (g_launcher_window) {
-        gtk_widget_destroy(g_launcher_window);
+        gtk_widget_hide(g_launcher_window);
     }
 }
 
@@ -573,8 +1084,10 @@ static void on_search_changed(GtkSearchEntry *entry, gpointer user_data)
     
     for (GList *it = children; it; it = it->next) {
         GtkWidget *child = GTK_WIDGET(it->data);
-        const char *name = g_object_get_data(G_OBJECT(child), "app-name");
-        if (!name) name = "";
+        /* children are GtkFlowBoxChild wrappers around the app buttons */
+        GtkWidget *btn = gtk_bin_get_child(GTK_BIN(child));
+        AppEntry *ae = btn ? app_entry_for_widget(btn) : NULL;
+        const char *name = ae ? app_entry_label(ae) : "";
         
         gboolean visible = smart_match(name, txt);
         gtk_widget_set_visible(child, visible);
@@ -615,10 +1128,22 @@ static GtkWidget *create_icon_button(const char *icon_name, const char *launch_c
 {
     GtkWidget *btn = gtk_button_new();
     GtkWidget *img = gtk_image_new_from_icon_name(icon_name, GTK_ICON_SIZE_DIALOG);
-    gtk_container_add(GTK_CONTAINER(btn), img);
+    GtkWidget *overlay = gtk_overlay_new();
+    gtk_container_add(GTK_CONTAINER(overlay), img);
+    gtk_container_add(GTK_CONTAINER(btn), overlay);
     
-    /* Store command for launching */
-    g_object_set_data_full(G_OBJECT(btn), "app-exec", g_strdup(launch_cmd), g_free);
+    /* CPU/RSS badge, filled in by the app usage sampler */
+    GtkWidget *badge = gtk_label_new(NULL);
+    gtk_style_context_add_class(gtk_widget_get_style_context(badge), "badge");
+    gtk_widget_set_halign(badge, GTK_ALIGN_CENTER);
+    gtk_widget_set_valign(badge, GTK_ALIGN_END);
+    gtk_widget_set_no_show_all(badge, TRUE);
+    gtk_overlay_add_overlay(GTK_OVERLAY(overlay), badge);
+    g_object_set_data(G_OBJECT(btn), "badge", badge);
+    
+    /* Store command for launching; borrowed, so launch_cmd must be a
+     * literal or a model string that outlives the button */
+    g_object_set_data(G_OBJECT(btn), "app-exec", (gpointer)launch_cmd);
     
     /* Connect click handler */
     g_signal_connect(btn, "button-press-event", G_CALLBACK(on_dock_button_press), NULL);
@@ -631,6 +1156,7 @@ static GtkWidget *create_icon_button(const char *icon_name, const char *launch_c
 static void update_favorites_bar(void)
 {
     if (!g_dock_box || !g_favorites) return;
+    if (g_preview) gtk_widget_destroy(g_preview);
     
     /* Remove existing buttons */
     GList *children = gtk_container_get_children(GTK_CONTAINER(g_dock_box));
@@ -641,38 +1167,1511 @@ static void update_favorites_bar(void)
     
     /* Add favorite apps */
     for (guint i = 0; i < g_favorites->len; ++i) {
-        FavoriteApp *app = g_ptr_array_index(g_favorites, i);
+        FavoriteApp *app = &g_array_index(g_favorites, FavoriteApp, i);
         GtkWidget *btn = create_icon_button(app->icon ? app->icon : "application-x-executable",
                                           app->exec);
+        /* favorite index + 1, for the window previews */
+        g_object_set_data(G_OBJECT(btn), "favorite-index", GUINT_TO_POINTER(i + 1));
+        g_signal_connect(btn, "enter-notify-event", G_CALLBACK(on_dock_button_crossing), NULL);
+        g_signal_connect(btn, "leave-notify-event", G_CALLBACK(on_dock_button_crossing), NULL);
         gtk_box_pack_start(GTK_BOX(g_dock_box), btn, FALSE, FALSE, 0);
     }
     
     gtk_widget_show_all(g_dock_box);
+
+    /* the new buttons start with hidden badges; show the last sample */
+    show_last_app_usage();
 }
 
-/* Window state change handler */
-static void on_window_state_changed(WnckScreen *screen, WnckWindow *window, gpointer data)
+static guint g_favorites_update_id = 0;
+
+static void update_app_sampler(void);
+
+static gboolean run_queued_favorites_update(gpointer user_data)
 {
+    (void)user_data;
+    g_favorites_update_id = 0;
     update_favorites_bar();
+    update_app_sampler();
+    return G_SOURCE_REMOVE;
 }
 
-int main(int argc, char **argv)
+/* Window state change handler. Bursts of window-opened/closed events are
+ * coalesced into one rebuild of the favorites bar per main loop iteration. */
+static void on_window_state_changed(WnckScreen *screen, WnckWindow *window, gpointer data)
 {
-    gtk_init(&argc, &argv);
-    gdk_set_program_class("dock");
-    
-    /* Initialize window tracking */
-    WnckHandle *handle = wnck_handle_new(WNCK_CLIENT_TYPE_APPLICATION);
-    g_wnck_screen = wnck_handle_get_default_screen(handle);
-    wnck_screen_force_update(g_wnck_screen);
-    g_signal_connect(G_OBJECT(g_wnck_screen), "window-opened",
-                    G_CALLBACK(on_window_state_changed), NULL);
-    g_signal_connect(G_OBJECT(g_wnck_screen), "window-closed",
-                    G_CALLBACK(on_window_state_changed), NULL);
-    
-    /* Load favorites */
-    load_favorites();
+    if (g_favorites_update_id == 0)
+        g_favorites_update_id = g_idle_add(run_queued_favorites_update, NULL);
+}
 
+/*
+ * Per-app resource badges
+ *
+ * The sampler walks /proc once per tick, reading each process's stat into a
+ * stack buffer, and charges CPU time to the favorite whose window belongs to
+ * that process or one of its ancestors; statm is only read for the processes
+ * that were charged. Samples go into two preallocated arrays that swap every
+ * tick, so a steady-state sample does not touch the heap.
+ *
+ * The rate is DOCK_SAMPLE_INTERVAL seconds (default 2, 0 disables). The
+ * timer only runs while the dock is mapped and not fully obscured, the
+ * session is not idle and at least one favorite has a window open. The
+ * session counts as idle while the screensaver is active or once there has
+ * been no keyboard or mouse input for INPUT_IDLE_SECONDS, as reported by
+ * the XScreenSaver extension; while idle, only that idle time is polled,
+ * every INPUT_IDLE_POLL_SECONDS, until input resumes.
+ *
+ * Each usage record remembers the favorite it was charged to, so a rebuild
+ * of the favorites bar shows the last sample again at once instead of
+ * blank badges until the next tick.
+ */
+#define INPUT_IDLE_SECONDS 60
+#define INPUT_IDLE_POLL_SECONDS 5
+
+typedef struct {
+    gint pid;
+    gint ppid;
+    guint64 ticks;      /* utime + stime */
+    gint slot;          /* favorite index; -1 none, -2 not yet resolved */
+} ProcSample;
+
+typedef struct {
+    gint pid;
+    gint slot;
+} ProcRoot;
+
+typedef struct {
+    const char *exec;   /* interned favorite exec this was charged to */
+    guint64 ticks;      /* CPU ticks since the previous sample */
+    glong rss_pages;    /* private resident pages (resident - shared) */
+    guint nprocs;
+} AppUsage;
+
+static DIR *g_proc_dir = NULL;
+static GArray *g_proc_now = NULL;           /* ProcSample, sorted by pid */
+static GArray *g_proc_prev = NULL;
+static GArray *g_proc_roots = NULL;         /* ProcRoot, one per app window */
+static GArray *g_app_usage = NULL;          /* AppUsage, one per favorite */
+static gint64 g_proc_prev_time = 0;
+static gdouble g_proc_elapsed = 0;          /* seconds covered by g_app_usage */
+static guint g_sample_interval = 2;
+static guint g_sampler_id = 0;
+static gboolean g_dock_visible = TRUE;
+static gboolean g_dock_obscured = FALSE;
+static gboolean g_session_idle = FALSE;     /* screensaver active */
+static gboolean g_input_idle = FALSE;       /* no input for INPUT_IDLE_SECONDS */
+static gboolean g_have_idle_query = FALSE;
+static guint g_input_idle_poll_id = 0;
+static GDBusConnection *g_session_bus = NULL;
+static guint g_screensaver_watch[2];
+
+/* Program name of an Exec line (basename of the first word after any
+ * "env VAR=value" prefix), returned as a slice of exec without copying */
+static const char *exec_program(const char *exec, gsize *len)
+{
+    const char *p = exec;
+    for (;;) {
+        while (*p == ' ') p++;
+        const char *end = p;
+        while (*end && *end != ' ') end++;
+        gboolean skip = (end - p == 3 && strncmp(p, "env", 3) == 0)
+                     || memchr(p, '=', end - p) != NULL;
+        if (skip && *end) { p = end; continue; }
+
+        const char *start = end;
+        while (start > p && start[-1] != '/') start--;
+        *len = end - start;
+        return start;
+    }
+}
+
+static gboolean name_is(const char *name, const char *prog, gsize len)
+{
+    return name && len && g_ascii_strncasecmp(name, prog, len) == 0 && name[len] == '\0';
+}
+
+/* TRUE if the window's WM_CLASS names the program of an Exec line */
+static gboolean window_runs_exec(WnckWindow *win, const char *exec)
+{
+    gsize len;
+    const char *prog = exec_program(exec, &len);
+    return name_is(wnck_window_get_class_instance_name(win), prog, len)
+        || name_is(wnck_window_get_class_group_name(win), prog, len);
+}
+
+/* Favorite whose program matches the window's WM_CLASS, or -1 */
+static gint favorite_for_window(WnckWindow *win)
+{
+    for (guint i = 0; g_favorites && i < g_favorites->len; ++i) {
+        FavoriteApp *app = &g_array_index(g_favorites, FavoriteApp, i);
+        if (app->exec && window_runs_exec(win, app->exec))
+            return i;
+    }
+    return -1;
+}
+
+/* One ProcRoot per window that belongs to a favorite */
+static void collect_app_roots(void)
+{
+    if (!g_proc_roots) g_proc_roots = g_array_new(FALSE, FALSE, sizeof(ProcRoot));
+    g_array_set_size(g_proc_roots, 0);
+    if (!g_wnck_screen) return;
+
+    for (GList *l = wnck_screen_get_windows(g_wnck_screen); l; l = l->next) {
+        WnckWindow *win = l->data;
+        ProcRoot root = { wnck_window_get_pid(win), favorite_for_window(win) };
+        if (root.pid > 0 && root.slot >= 0)
+            g_array_append_val(g_proc_roots, root);
+    }
+}
+
+/* Read fields 4 (ppid), 14 (utime) and 15 (stime) of /proc/<pid>/stat */
+static gboolean read_proc_stat(int dir_fd, const char *pid, ProcSample *out)
+{
+    char path[32], buf[1024];
+    g_snprintf(path, sizeof path, "%s/stat", pid);
+    int fd = openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return FALSE;
+    ssize_t n = read(fd, buf, sizeof buf - 1);
+    close(fd);
+    if (n <= 0) return FALSE;
+    buf[n] = '\0';
+
+    /* comm may contain spaces and ')'; the fields resume after the last ')' */
+    const char *p = strrchr(buf, ')');
+    unsigned long utime, stime;
+    if (!p || sscanf(p + 1, " %*c %d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+                     &out->ppid, &utime, &stime) != 3)
+        return FALSE;
+    out->pid = atoi(pid);
+    out->ticks = (guint64)utime + stime;
+    out->slot = -2;
+    return TRUE;
+}
+
+/* Resident minus shared pages from /proc/<pid>/statm */
+static glong read_proc_private_pages(gint pid)
+{
+    char path[32], buf[128];
+    glong size, resident, shared;
+    g_snprintf(path, sizeof path, "%d/statm", pid);
+    int fd = openat(dirfd(g_proc_dir), path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    ssize_t n = read(fd, buf, sizeof buf - 1);
+    close(fd);
+    if (n <= 0) return 0;
+    buf[n] = '\0';
+    if (sscanf(buf, "%ld %ld %ld", &size, &resident, &shared) != 3) return 0;
+    return MAX(resident - shared, 0);
+}
+
+static gint compare_proc_pid(gconstpointer a, gconstpointer b)
+{
+    gint x = ((const ProcSample *)a)->pid, y = ((const ProcSample *)b)->pid;
+    return x < y ? -1 : x > y;
+}
+
+static ProcSample *find_proc(GArray *procs, gint pid)
+{
+    ProcSample key = { pid, 0, 0, 0 };
+    return bsearch(&key, procs->data, procs->len, sizeof(ProcSample), compare_proc_pid);
+}
+
+/* Slot of the nearest ancestor (or self) that owns an app window */
+static gint resolve_proc_slot(GArray *procs, ProcSample *ps, guint depth)
+{
+    if (ps->slot != -2) return ps->slot;
+    ps->slot = -1;
+    ProcSample *parent = ps->ppid > 1 && depth < 64 ? find_proc(procs, ps->ppid) : NULL;
+    if (parent) ps->slot = resolve_proc_slot(procs, parent, depth + 1);
+    return ps->slot;
+}
+
+/* Snapshot every process into g_proc_now and attribute it to an app */
+static void scan_processes(void)
+{
+    if (!g_proc_dir && !(g_proc_dir = opendir("/proc"))) return;
+    if (!g_proc_now) g_proc_now = g_array_new(FALSE, FALSE, sizeof(ProcSample));
+    g_array_set_size(g_proc_now, 0);
+
+    rewinddir(g_proc_dir);
+    int dir_fd = dirfd(g_proc_dir);
+    gboolean sorted = TRUE;
+    struct dirent *de;
+    while ((de = readdir(g_proc_dir)) != NULL) {
+        if (!g_ascii_isdigit(de->d_name[0])) continue;
+        ProcSample ps;
+        if (!read_proc_stat(dir_fd, de->d_name, &ps)) continue;
+        if (g_proc_now->len &&
+            g_array_index(g_proc_now, ProcSample, g_proc_now->len - 1).pid > ps.pid)
+            sorted = FALSE;
+        g_array_append_val(g_proc_now, ps);
+    }
+    /* procfs lists pids in ascending order; sort only if it ever does not */
+    if (!sorted)
+        qsort(g_proc_now->data, g_proc_now->len, sizeof(ProcSample), compare_proc_pid);
+
+    for (guint i = 0; g_proc_roots && i < g_proc_roots->len; ++i) {
+        ProcRoot *root = &g_array_index(g_proc_roots, ProcRoot, i);
+        ProcSample *ps = find_proc(g_proc_now, root->pid);
+        if (ps) ps->slot = root->slot;
+    }
+    for (guint i = 0; i < g_proc_now->len; ++i)
+        resolve_proc_slot(g_proc_now, &g_array_index(g_proc_now, ProcSample, i), 0);
+}
+
+/* Sum the new snapshot per favorite against the previous one, then swap */
+static void account_app_usage(void)
+{
+    guint nslots = g_favorites ? g_favorites->len : 0;
+    if (!g_app_usage) g_app_usage = g_array_new(FALSE, FALSE, sizeof(AppUsage));
+    g_array_set_size(g_app_usage, nslots);
+    if (nslots) memset(g_app_usage->data, 0, nslots * sizeof(AppUsage));
+    for (guint i = 0; i < nslots; ++i)
+        g_array_index(g_app_usage, AppUsage, i).exec =
+            g_array_index(g_favorites, FavoriteApp, i).exec;
+
+    for (guint i = 0; g_proc_now && i < g_proc_now->len; ++i) {
+        ProcSample *ps = &g_array_index(g_proc_now, ProcSample, i);
+        if (ps->slot < 0 || (guint)ps->slot >= nslots) continue;
+        AppUsage *u = &g_array_index(g_app_usage, AppUsage, ps->slot);
+        ProcSample *prev = g_proc_prev ? find_proc(g_proc_prev, ps->pid) : NULL;
+        /* a pid absent last time (or reused) started since then */
+        u->ticks += prev && prev->ticks <= ps->ticks ? ps->ticks - prev->ticks : ps->ticks;
+        u->rss_pages += read_proc_private_pages(ps->pid);
+        u->nprocs++;
+    }
+
+    GArray *tmp = g_proc_prev;
+    g_proc_prev = g_proc_now;
+    g_proc_now = tmp;
+}
+
+static void format_badge(char *buf, gsize size, gdouble cpu, glong rss_kb)
+{
+    if (rss_kb >= 1024 * 1024)
+        g_snprintf(buf, size, "%.0f%% %.1fG", cpu, rss_kb / (1024.0 * 1024.0));
+    else
+        g_snprintf(buf, size, "%.0f%% %ldM", cpu, rss_kb / 1024);
+}
+
+/* Usage last charged to the favorite at index, which may have moved since */
+static AppUsage *app_usage_for_favorite(guint index)
+{
+    if (!g_app_usage || !g_favorites || index >= g_favorites->len) return NULL;
+    const char *exec = g_array_index(g_favorites, FavoriteApp, index).exec;
+    if (index < g_app_usage->len &&
+        g_array_index(g_app_usage, AppUsage, index).exec == exec)
+        return &g_array_index(g_app_usage, AppUsage, index);
+    for (guint i = 0; i < g_app_usage->len; ++i)
+        if (g_array_index(g_app_usage, AppUsage, i).exec == exec)
+            return &g_array_index(g_app_usage, AppUsage, i);
+    return NULL;
+}
+
+/* Show the latest usage on the favorites bar; hide badges when elapsed is 0 */
+static void update_badges(gdouble elapsed)
+{
+    if (!g_dock_box) return;
+    static glong page_kb = 0, clk_tck = 0;
+    if (!page_kb) page_kb = sysconf(_SC_PAGESIZE) / 1024;
+    if (!clk_tck) clk_tck = sysconf(_SC_CLK_TCK);
+
+    GList *children = gtk_container_get_children(GTK_CONTAINER(g_dock_box));
+    guint i = 0;
+    for (GList *it = children; it; it = it->next, ++i) {
+        GtkWidget *badge = g_object_get_data(G_OBJECT(it->data), "badge");
+        if (!badge) continue;
+        AppUsage *u = elapsed > 0 ? app_usage_for_favorite(i) : NULL;
+        if (!u || u->nprocs == 0) {
+            gtk_widget_hide(badge);
+            continue;
+        }
+        char text[32];
+        format_badge(text, sizeof text, 100.0 * u->ticks / (elapsed * clk_tck),
+                     u->rss_pages * page_kb);
+        if (g_strcmp0(gtk_label_get_text(GTK_LABEL(badge)), text) != 0)
+            gtk_label_set_text(GTK_LABEL(badge), text);
+        gtk_widget_show(badge);
+    }
+    g_list_free(children);
+}
+
+/* Milliseconds since the last keyboard or mouse input, or -1 if unknown */
+static glong input_idle_ms(void)
+{
+    if (!g_have_idle_query) return -1;
+    Display *xdisplay = GDK_DISPLAY_XDISPLAY(gdk_display_get_default());
+    XScreenSaverInfo info;
+    if (!XScreenSaverQueryInfo(xdisplay, DefaultRootWindow(xdisplay), &info)) return -1;
+    return (glong)info.idle;
+}
+
+/* While input is idle, wait for it to resume without sampling /proc */
+static gboolean poll_input_idle(gpointer user_data)
+{
+    (void)user_data;
+    if (input_idle_ms() >= INPUT_IDLE_SECONDS * 1000) return G_SOURCE_CONTINUE;
+    g_input_idle_poll_id = 0;
+    g_input_idle = FALSE;
+    update_app_sampler();
+    return G_SOURCE_REMOVE;
+}
+
+/* Badges of a rebuilt favorites bar, from the sample still being shown */
+static void show_last_app_usage(void)
+{
+    if (g_sampler_id) update_badges(g_proc_elapsed);
+}
+
+static gboolean sample_app_usage(gpointer user_data)
+{
+    (void)user_data;
+    if (input_idle_ms() >= INPUT_IDLE_SECONDS * 1000) {
+        /* returning G_SOURCE_REMOVE stops the sampler timer */
+        g_input_idle = TRUE;
+        g_input_idle_poll_id = g_timeout_add_seconds(INPUT_IDLE_POLL_SECONDS,
+                                                     poll_input_idle, NULL);
+        g_sampler_id = 0;
+        update_badges(0);
+        return G_SOURCE_REMOVE;
+    }
+
+    gint64 now = g_get_monotonic_time();
+    gdouble elapsed = g_proc_prev_time
+                    ? (now - g_proc_prev_time) / (gdouble)G_USEC_PER_SEC : 0;
+
+    collect_app_roots();
+    scan_processes();
+    account_app_usage();
+    g_proc_prev_time = now;
+    g_proc_elapsed = elapsed;
+    update_badges(elapsed);
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean app_sampler_wanted(void)
+{
+    if (!g_sample_interval || !g_dock_visible || g_dock_obscured ||
+        g_session_idle || g_input_idle || !g_wnck_screen)
+        return FALSE;
+    for (GList *l = wnck_screen_get_windows(g_wnck_screen); l; l = l->next)
+        if (favorite_for_window(l->data) >= 0) return TRUE;
+    return FALSE;
+}
+
+/* Start or stop the sampler to match the dock's state */
+static void update_app_sampler(void)
+{
+    gboolean wanted = app_sampler_wanted();
+    if (wanted && !g_sampler_id) {
+        /* prime the previous snapshot so the first tick has a baseline */
+        g_proc_prev_time = 0;
+        if (sample_app_usage(NULL) == G_SOURCE_CONTINUE)
+            g_sampler_id = g_timeout_add_seconds(g_sample_interval, sample_app_usage, NULL);
+    } else if (!wanted && g_sampler_id) {
+        g_source_remove(g_sampler_id);
+        g_sampler_id = 0;
+        update_badges(0);
+    }
+}
+
+/* Stop sampling and release the sampler's buffers */
+static void free_app_sampler(void)
+{
+    if (g_sampler_id) {
+        g_source_remove(g_sampler_id);
+        g_sampler_id = 0;
+    }
+    if (g_input_idle_poll_id) {
+        g_source_remove(g_input_idle_poll_id);
+        g_input_idle_poll_id = 0;
+    }
+    if (g_session_bus) {
+        for (guint i = 0; i < G_N_ELEMENTS(g_screensaver_watch); ++i)
+            if (g_screensaver_watch[i])
+                g_dbus_connection_signal_unsubscribe(g_session_bus, g_screensaver_watch[i]);
+        g_clear_object(&g_session_bus);
+    }
+    g_clear_pointer(&g_proc_now, g_array_unref);
+    g_clear_pointer(&g_proc_prev, g_array_unref);
+    g_clear_pointer(&g_proc_roots, g_array_unref);
+    g_clear_pointer(&g_app_usage, g_array_unref);
+    if (g_proc_dir) {
+        closedir(g_proc_dir);
+        g_proc_dir = NULL;
+    }
+}
+
+static gboolean on_dock_map_changed(GtkWidget *widget, GdkEvent *event, gpointer data)
+{
+    g_dock_visible = (event->type == GDK_MAP);
+    update_app_sampler();
+    return FALSE;
+}
+
+static gboolean on_dock_state_changed(GtkWidget *widget, GdkEventWindowState *event, gpointer data)
+{
+    g_dock_visible = !(event->new_window_state &
+                       (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN));
+    update_app_sampler();
+    return FALSE;
+}
+
+static gboolean on_dock_visibility_changed(GtkWidget *widget, GdkEventVisibility *event,
+                                           gpointer data)
+{
+    g_dock_obscured = (event->state == GDK_VISIBILITY_FULLY_OBSCURED);
+    update_app_sampler();
+    return FALSE;
+}
+
+static void on_screensaver_active_changed(GDBusConnection *bus, const gchar *sender,
+                                          const gchar *path, const gchar *iface,
+                                          const gchar *signal, GVariant *params,
+                                          gpointer data)
+{
+    if (!g_variant_is_of_type(params, G_VARIANT_TYPE("(b)"))) return;
+    g_variant_get(params, "(b)", &g_session_idle);
+    update_app_sampler();
+}
+
+/*
+ * Launch history and readahead
+ *
+ * Every launch bumps a per-command record (count, last launch time and a
+ * score that halves every LAUNCH_HALF_LIFE_DAYS) kept in
+ * ~/.config/dock/launch-history, which the Flutter dock updates as well.
+ * In idle time after startup a worker thread pulls the programs of the
+ * PREFETCH_TOP_N highest scoring commands, and transitively the DT_NEEDED
+ * libraries they load, into the page cache with readahead(2), so the first
+ * launch after login does not wait on the disk.
+ *
+ * The first launch of each command per session is timed until its first
+ * window maps, split by whether it was prefetched; SIGUSR1 reports both.
+ * The two groups are different apps, so their means are not a measure of
+ * the readahead; `dock_bench --launch CMD` times the same command with its
+ * files evicted from the page cache, with and without the readahead.
+ */
+#define LAUNCH_HALF_LIFE_DAYS 7.0
+#define PREFETCH_TOP_N 5
+#define PREFETCH_MAX_BYTES ((guint64)256 * 1024 * 1024)
+#define LAUNCH_TIMEOUT_US (30 * G_USEC_PER_SEC)
+
+#if __SIZEOF_POINTER__ == 8
+#define ELF_NATIVE_CLASS ELFCLASS64
+#else
+#define ELF_NATIVE_CLASS ELFCLASS32
+#endif
+
+typedef struct {
+    const char *exec;   /* interned */
+    guint count;
+    gint64 last;        /* wall-clock seconds */
+    gdouble score;      /* as of `last` */
+} LaunchRecord;
+
+typedef struct {
+    const char *exec;   /* interned */
+    gint64 started;     /* monotonic */
+    gboolean prefetched;
+} PendingLaunch;
+
+static GArray *g_launch_history = NULL;     /* LaunchRecord */
+static GArray *g_pending_launches = NULL;   /* PendingLaunch */
+static GHashTable *g_launched = NULL;       /* execs launched this session */
+static GHashTable *g_prefetched = NULL;     /* execs whose files were read ahead */
+static guint g_cold_launches = 0, g_warm_launches = 0;
+static gint64 g_cold_launch_us = 0, g_warm_launch_us = 0;
+
+static gchar *launch_history_path(void)
+{
+    return g_build_filename(g_get_user_config_dir(), "dock", "launch-history", NULL);
+}
+
+static gdouble launch_score(const LaunchRecord *rec, gint64 now)
+{
+    gdouble age_days = MAX(now - rec->last, 0) / 86400.0;
+    return rec->score * pow(0.5, age_days / LAUNCH_HALF_LIFE_DAYS);
+}
+
+/*
+ * The history file is shared with the Flutter dock
+ * (lib/common/services/launch_history.dart), so every update is a locked
+ * read-merge-write. The lock is an fcntl() record lock on
+ * "launch-history.lock", not flock(): Dart's RandomAccessFile.lock takes
+ * fcntl locks, and on Linux the two kinds do not exclude each other.
+ * Returns the locked descriptor (closing it unlocks), or -1.
+ */
+static int lock_launch_history(const char *path)
+{
+    gchar *dir = g_path_get_dirname(path);
+    g_mkdir_with_parents(dir, 0755);
+    g_free(dir);
+
+    gchar *lock_path = g_strconcat(path, ".lock", NULL);
+    int fd = open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    g_free(lock_path);
+    if (fd < 0) return -1;
+
+    struct flock fl = { .l_type = F_WRLCK, .l_whence = SEEK_SET };
+    while (fcntl(fd, F_SETLKW, &fl) < 0) {
+        if (errno != EINTR) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+/* Replace g_launch_history with the records in content.
+ * One "count<TAB>last<TAB>score<TAB>exec" line per command. */
+static void parse_launch_history(const char *content)
+{
+    if (!g_launch_history)
+        g_launch_history = g_array_new(FALSE, TRUE, sizeof(LaunchRecord));
+    g_array_set_size(g_launch_history, 0);
+
+    gchar **lines = g_strsplit(content, "\n", -1);
+    for (gchar **l = lines; *l; ++l) {
+        gchar **f = g_strsplit(*l, "\t", 4);
+        if (g_strv_length(f) == 4 && *f[3]) {
+            LaunchRecord rec = {
+                model_intern(f[3]),
+                (guint)g_ascii_strtoull(f[0], NULL, 10),
+                g_ascii_strtoll(f[1], NULL, 10),
+                g_ascii_strtod(f[2], NULL),
+            };
+            g_array_append_val(g_launch_history, rec);
+        }
+        g_strfreev(f);
+    }
+    g_strfreev(lines);
+}
+
+/* Read the history once, for ranking at startup */
+static void load_launch_history(void)
+{
+    if (g_launch_history) return;
+    gchar *path = launch_history_path();
+    gchar *content = NULL;
+    g_file_get_contents(path, &content, NULL, NULL);
+    parse_launch_history(content ? content : "");
+    g_free(content);
+    g_free(path);
+}
+
+static void count_launch(LaunchRecord *rec, gint64 now)
+{
+    rec->score = launch_score(rec, now) + 1.0;
+    rec->last = now;
+    rec->count++;
+}
+
+static void append_launch_record(GString *out, const LaunchRecord *rec)
+{
+    char score[G_ASCII_DTOSTR_BUF_SIZE];
+    g_string_append_printf(out, "%u\t%" G_GINT64_FORMAT "\t%s\t%s\n", rec->count, rec->last,
+                           g_ascii_dtostr(score, sizeof score, rec->score), rec->exec);
+}
+
+/*
+ * Launches are merged into the file on a worker thread, so the lock wait,
+ * the read and the write never block the main loop. fcntl locks belong to
+ * the process, not the thread, so only one merge runs at a time; launches
+ * made meanwhile queue up and go into the next one.
+ */
+typedef struct {
+    gchar *exec;
+    gint64 when;        /* wall-clock seconds */
+} QueuedLaunch;
+
+static GArray *g_launch_queue = NULL;       /* QueuedLaunch, not yet merged */
+static gboolean g_launch_merging = FALSE;
+
+static void clear_queued_launch(gpointer data)
+{
+    g_free(((QueuedLaunch *)data)->exec);
+}
+
+/* Apply a batch of QueuedLaunch to the file under the lock and return the
+ * merged content; on a lock failure the merge is returned unsaved */
+static void merge_launches_thread(GTask *task, gpointer source, gpointer task_data,
+                                  GCancellable *cancel)
+{
+    GArray *batch = task_data;
+    gboolean *merged = g_new0(gboolean, batch->len);
+    gchar *path = launch_history_path();
+    int lock = lock_launch_history(path);
+    gchar *content = NULL;
+    g_file_get_contents(path, &content, NULL, NULL);
+
+    GString *out = g_string_new("");
+    gchar **lines = g_strsplit(content ? content : "", "\n", -1);
+    for (gchar **l = lines; *l; ++l) {
+        gchar **f = g_strsplit(*l, "\t", 4);
+        if (g_strv_length(f) == 4 && *f[3]) {
+            LaunchRecord rec = {
+                f[3],
+                (guint)g_ascii_strtoull(f[0], NULL, 10),
+                g_ascii_strtoll(f[1], NULL, 10),
+                g_ascii_strtod(f[2], NULL),
+            };
+            for (guint i = 0; i < batch->len; ++i) {
+                QueuedLaunch *q = &g_array_index(batch, QueuedLaunch, i);
+                if (strcmp(q->exec, rec.exec) != 0) continue;
+                count_launch(&rec, q->when);
+                merged[i] = TRUE;
+            }
+            append_launch_record(out, &rec);
+        }
+        g_strfreev(f);
+    }
+    g_strfreev(lines);
+
+    /* Commands launched for the first time */
+    for (guint i = 0; i < batch->len; ++i) {
+        if (merged[i]) continue;
+        QueuedLaunch *q = &g_array_index(batch, QueuedLaunch, i);
+        LaunchRecord rec = { q->exec, 0, q->when, 0 };
+        for (guint j = i; j < batch->len; ++j) {
+            QueuedLaunch *r = &g_array_index(batch, QueuedLaunch, j);
+            if (merged[j] || strcmp(r->exec, q->exec) != 0) continue;
+            count_launch(&rec, r->when);
+            merged[j] = TRUE;
+        }
+        append_launch_record(out, &rec);
+    }
+
+    /* g_file_set_contents writes a uniquely named temporary file in the
+     * same directory and renames it over the old one */
+    if (lock >= 0) {
+        g_file_set_contents(path, out->str, out->len, NULL);
+        close(lock);
+    }
+    g_free(content);
+    g_free(path);
+    g_free(merged);
+    g_task_return_pointer(task, g_string_free(out, FALSE), g_free);
+}
+
+static void start_launch_merge(void);
+
+static void on_launches_merged(GObject *source, GAsyncResult *result, gpointer data)
+{
+    gchar *content = g_task_propagate_pointer(G_TASK(result), NULL);
+    g_launch_merging = FALSE;
+    if (content) parse_launch_history(content);
+    g_free(content);
+    start_launch_merge();
+}
+
+/* Merge the queued launches on a worker thread, unless one is running */
+static void start_launch_merge(void)
+{
+    if (g_launch_merging || !g_launch_queue || g_launch_queue->len == 0) return;
+    GArray *batch = g_launch_queue;
+    g_launch_queue = NULL;
+    g_launch_merging = TRUE;
+
+    GTask *task = g_task_new(NULL, NULL, on_launches_merged, NULL);
+    g_task_set_task_data(task, batch, (GDestroyNotify)g_array_unref);
+    g_task_run_in_thread(task, merge_launches_thread);
+    g_object_unref(task);
+}
+
+/* Count a launch of cmd and start timing it if it is the first this session */
+static void record_launch(const char *cmd)
+{
+    const char *exec = model_intern(cmd);
+
+    /* Merge with whatever the Flutter dock wrote since our last read */
+    if (!g_launch_queue) {
+        g_launch_queue = g_array_new(FALSE, FALSE, sizeof(QueuedLaunch));
+        g_array_set_clear_func(g_launch_queue, clear_queued_launch);
+    }
+    QueuedLaunch q = { g_strdup(exec), g_get_real_time() / G_USEC_PER_SEC };
+    g_array_append_val(g_launch_queue, q);
+    start_launch_merge();
+
+    if (!g_launched) g_launched = g_hash_table_new(g_direct_hash, g_direct_equal);
+    if (!g_hash_table_add(g_launched, (gpointer)exec)) return;
+    if (!g_pending_launches) g_pending_launches = g_array_new(FALSE, FALSE, sizeof(PendingLaunch));
+    PendingLaunch pl = {
+        exec, g_get_monotonic_time(),
+        g_prefetched && g_hash_table_contains(g_prefetched, exec),
+    };
+    g_array_append_val(g_pending_launches, pl);
+}
+
+/* Finish timing the pending launch that this window belongs to */
+static void on_launch_window_opened(WnckWindow *win)
+{
+    if (!g_pending_launches || !win) return;
+    gint64 now = g_get_monotonic_time();
+
+    for (guint i = g_pending_launches->len; i-- > 0;) {
+        PendingLaunch *pl = &g_array_index(g_pending_launches, PendingLaunch, i);
+        gint64 dt = now - pl->started;
+        if (dt > LAUNCH_TIMEOUT_US) {
+            g_array_remove_index_fast(g_pending_launches, i);
+            continue;
+        }
+        if (!window_runs_exec(win, pl->exec)) continue;
+
+        g_debug("launch: %s mapped a window after %.0f ms (%s)", pl->exec, dt / 1000.0,
+                pl->prefetched ? "prefetched" : "cold");
+        if (pl->prefetched) {
+            g_warm_launches++;
+            g_warm_launch_us += dt;
+        } else {
+            g_cold_launches++;
+            g_cold_launch_us += dt;
+        }
+        g_array_remove_index_fast(g_pending_launches, i);
+        break;
+    }
+}
+
+static void report_launch_latency(void)
+{
+    if (!g_cold_launches && !g_warm_launches) return;
+    gdouble cold = g_cold_launches ? g_cold_launch_us / 1000.0 / g_cold_launches : 0;
+    gdouble warm = g_warm_launches ? g_warm_launch_us / 1000.0 / g_warm_launches : 0;
+    g_message("first launches: %u cold (mean %.0f ms), %u prefetched (mean %.0f ms)",
+              g_cold_launches, cold, g_warm_launches, warm);
+}
+
+/* Worker-thread state for one prefetch run */
+typedef struct {
+    GHashTable *seen;       /* canonical paths already read */
+    GPtrArray *lib_dirs;    /* library search path */
+    guint files;
+    guint64 bytes;
+} Prefetch;
+
+static void prefetch_file(Prefetch *pf, const char *path, guint depth);
+
+/* Library search path: LD_LIBRARY_PATH, ld.so.conf.d and the usual dirs */
+static GPtrArray *library_dirs(void)
+{
+    GPtrArray *dirs = g_ptr_array_new_with_free_func(g_free);
+    const char *ld_path = g_getenv("LD_LIBRARY_PATH");
+    if (ld_path) {
+        gchar **parts = g_strsplit(ld_path, ":", -1);
+        for (gchar **p = parts; *p; ++p)
+            if (**p) g_ptr_array_add(dirs, g_strdup(*p));
+        g_strfreev(parts);
+    }
+
+    GDir *conf = g_dir_open("/etc/ld.so.conf.d", 0, NULL);
+    const char *name;
+    while (conf && (name = g_dir_read_name(conf)) != NULL) {
+        if (!g_str_has_suffix(name, ".conf")) continue;
+        gchar *file = g_build_filename("/etc/ld.so.conf.d", name, NULL);
+        gchar *content = NULL;
+        if (g_file_get_contents(file, &content, NULL, NULL)) {
+            gchar **lines = g_strsplit(content, "\n", -1);
+            for (gchar **l = lines; *l; ++l) {
+                gchar *line = g_strstrip(*l);
+                if (*line == '/') g_ptr_array_add(dirs, g_strdup(line));
+            }
+            g_strfreev(lines);
+            g_free(content);
+        }
+        g_free(file);
+    }
+    if (conf) g_dir_close(conf);
+
+    static const char *defaults[] = {
+        "/usr/local/lib", "/lib64", "/usr/lib64", "/lib", "/usr/lib", NULL
+    };
+    for (const char **d = defaults; *d; ++d)
+        g_ptr_array_add(dirs, g_strdup(*d));
+    return dirs;
+}
+
+/* Resolve a DT_NEEDED name the way ld.so would (RUNPATH, then the search path) */
+static gchar *find_library(Prefetch *pf, const char *name, const char *runpath, const char *origin)
+{
+    if (strchr(name, '/')) return g_strdup(name);
+
+    if (runpath) {
+        gchar **parts = g_strsplit(runpath, ":", -1);
+        for (gchar **p = parts; *p; ++p) {
+            const char *rest = g_str_has_prefix(*p, "${ORIGIN}") ? *p + 9
+                             : g_str_has_prefix(*p, "$ORIGIN") ? *p + 7 : NULL;
+            gchar *expanded = rest ? g_strconcat(origin, rest, NULL) : NULL;
+            gchar *path = g_build_filename(expanded ? expanded : *p, name, NULL);
+            g_free(expanded);
+            if (access(path, R_OK) == 0) {
+                g_strfreev(parts);
+                return path;
+            }
+            g_free(path);
+        }
+        g_strfreev(parts);
+    }
+    for (guint i = 0; i < pf->lib_dirs->len; ++i) {
+        gchar *path = g_build_filename(g_ptr_array_index(pf->lib_dirs, i), name, NULL);
+        if (access(path, R_OK) == 0) return path;
+        g_free(path);
+    }
+    return NULL;
+}
+
+/* File offset of a virtual address, from the PT_LOAD segments */
+static gsize elf_offset(const ElfW(Phdr) *ph, guint phnum, ElfW(Addr) addr)
+{
+    for (guint i = 0; i < phnum; ++i) {
+        if (ph[i].p_type == PT_LOAD && addr >= ph[i].p_vaddr &&
+            addr < ph[i].p_vaddr + ph[i].p_filesz)
+            return addr - ph[i].p_vaddr + ph[i].p_offset;
+    }
+    return 0;
+}
+
+/* Read ahead every DT_NEEDED library of a mapped ELF file; origin is the
+ * directory of the file, for $ORIGIN in its RUNPATH */
+static void prefetch_needed(Prefetch *pf, const guchar *map, gsize size,
+                            const char *origin, guint depth)
+{
+    const ElfW(Ehdr) *eh = (const ElfW(Ehdr) *)map;
+    if (size < sizeof *eh || memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+        eh->e_ident[EI_CLASS] != ELF_NATIVE_CLASS || eh->e_phentsize != sizeof(ElfW(Phdr)) ||
+        eh->e_phoff + (gsize)eh->e_phnum * sizeof(ElfW(Phdr)) > size)
+        return;
+
+    const ElfW(Phdr) *ph = (const ElfW(Phdr) *)(map + eh->e_phoff);
+    const ElfW(Dyn) *dyn = NULL;
+    gsize ndyn = 0;
+    for (guint i = 0; i < eh->e_phnum; ++i) {
+        if (ph[i].p_type == PT_DYNAMIC && ph[i].p_offset + ph[i].p_filesz <= size) {
+            dyn = (const ElfW(Dyn) *)(map + ph[i].p_offset);
+            ndyn = ph[i].p_filesz / sizeof(ElfW(Dyn));
+        }
+    }
+    if (!dyn) return;
+
+    gsize strtab = 0, strsz = 0, runpath = 0;
+    gboolean have_runpath = FALSE;
+    for (gsize i = 0; i < ndyn && dyn[i].d_tag != DT_NULL; ++i) {
+        if (dyn[i].d_tag == DT_STRTAB) strtab = elf_offset(ph, eh->e_phnum, dyn[i].d_un.d_ptr);
+        else if (dyn[i].d_tag == DT_STRSZ) strsz = dyn[i].d_un.d_val;
+        else if (dyn[i].d_tag == DT_RUNPATH || (dyn[i].d_tag == DT_RPATH && !have_runpath)) {
+            runpath = dyn[i].d_un.d_val;
+            have_runpath = TRUE;
+        }
+    }
+    if (!strtab || strtab + strsz > size) return;
+
+    const char *strs = (const char *)map + strtab;
+    const char *rp = have_runpath && runpath < strsz ? strs + runpath : NULL;
+    for (gsize i = 0; i < ndyn && dyn[i].d_tag != DT_NULL; ++i) {
+        if (dyn[i].d_tag != DT_NEEDED || dyn[i].d_un.d_val >= strsz) continue;
+        gchar *lib = find_library(pf, strs + dyn[i].d_un.d_val, rp, origin);
+        if (lib) prefetch_file(pf, lib, depth + 1);
+        g_free(lib);
+    }
+}
+
+/* Interpreter of a "#!" script, resolving "/usr/bin/env prog" to prog */
+static gchar *script_interpreter(const guchar *map, gsize size)
+{
+    if (size < 3 || map[0] != '#' || map[1] != '!') return NULL;
+    const guchar *nl = memchr(map, '\n', MIN(size, 256));
+    if (!nl) return NULL;
+    gchar *line = g_strndup((const char *)map + 2, nl - map - 2);
+    gchar **words = g_strsplit_set(g_strstrip(line), " \t", -1);
+    gchar *interp = NULL;
+    if (words[0] && g_str_has_suffix(words[0], "/env") && words[1])
+        interp = g_find_program_in_path(words[1]);
+    else if (words[0] && *words[0])
+        interp = g_strdup(words[0]);
+    g_strfreev(words);
+    g_free(line);
+    return interp;
+}
+
+/* Pull a file into the page cache, then whatever it loads */
+static void prefetch_file(Prefetch *pf, const char *path, guint depth)
+{
+    if (depth > 16 || pf->bytes >= PREFETCH_MAX_BYTES) return;
+    char *real = realpath(path, NULL);
+    if (!real) return;
+    gchar *canonical = g_strdup(real);
+    free(real);
+    if (!g_hash_table_add(pf->seen, canonical)) return;
+
+    int fd = open(canonical, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        close(fd);
+        return;
+    }
+    readahead(fd, 0, st.st_size);
+    pf->files++;
+    pf->bytes += st.st_size;
+
+    guchar *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return;
+
+    gchar *interp = script_interpreter(map, st.st_size);
+    if (interp) {
+        prefetch_file(pf, interp, depth + 1);
+        g_free(interp);
+    } else {
+        gchar *dir = g_path_get_dirname(canonical);
+        prefetch_needed(pf, map, st.st_size, dir, depth);
+        g_free(dir);
+    }
+    munmap(map, st.st_size);
+}
+
+/* Program an Exec line runs, as an absolute path */
+static gchar *program_path_for_exec(const char *exec)
+{
+    gchar **argv = NULL;
+    if (!g_shell_parse_argv(exec, NULL, &argv, NULL)) return NULL;
+    gchar **a = argv;
+    if (*a && g_strcmp0(*a, "env") == 0) a++;
+    while (*a && strchr(*a, '=') && **a != '/') a++;
+    gchar *path = *a ? (g_path_is_absolute(*a) ? g_strdup(*a) : g_find_program_in_path(*a)) : NULL;
+    g_strfreev(argv);
+    return path;
+}
+
+static void prefetch_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancel)
+{
+    GPtrArray *execs = task_data;
+    GPtrArray *done = g_ptr_array_new_with_free_func(g_free);
+    Prefetch pf = { g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL), library_dirs(), 0, 0 };
+    gint64 start = g_get_monotonic_time();
+
+    for (guint i = 0; i < execs->len; ++i) {
+        gchar *prog = program_path_for_exec(g_ptr_array_index(execs, i));
+        if (!prog) continue;
+        prefetch_file(&pf, prog, 0);
+        g_ptr_array_add(done, g_strdup(g_ptr_array_index(execs, i)));
+        g_free(prog);
+    }
+    g_debug("prefetch: %u apps, %u files, %.1f MiB in %.0f ms", done->len, pf.files,
+            pf.bytes / (1024.0 * 1024.0), (g_get_monotonic_time() - start) / 1000.0);
+
+    g_ptr_array_free(pf.lib_dirs, TRUE);
+    g_hash_table_destroy(pf.seen);
+    g_task_return_pointer(task, done, (GDestroyNotify)g_ptr_array_unref);
+}
+
+static void on_prefetch_done(GObject *source, GAsyncResult *result, gpointer data)
+{
+    GPtrArray *done = g_task_propagate_pointer(G_TASK(result), NULL);
+    if (!done) return;
+    if (!g_prefetched) g_prefetched = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < done->len; ++i)
+        g_hash_table_add(g_prefetched, (gpointer)model_intern(g_ptr_array_index(done, i)));
+    g_ptr_array_unref(done);
+}
+
+static gint compare_launch_score(gconstpointer a, gconstpointer b, gpointer now)
+{
+    gdouble x = launch_score(a, *(gint64 *)now), y = launch_score(b, *(gint64 *)now);
+    return x > y ? -1 : x < y;
+}
+
+/* Read ahead the top PREFETCH_TOP_N commands on a worker thread */
+static void prefetch_top_apps(void)
+{
+    load_launch_history();
+    if (g_launch_history->len == 0) return;
+
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    GArray *ranked = g_array_copy(g_launch_history);
+    g_array_sort_with_data(ranked, compare_launch_score, &now);
+    GPtrArray *execs = g_ptr_array_new_with_free_func(g_free);
+    for (guint i = 0; i < ranked->len && i < PREFETCH_TOP_N; ++i)
+        g_ptr_array_add(execs, g_strdup(g_array_index(ranked, LaunchRecord, i).exec));
+    g_array_unref(ranked);
+
+    GTask *task = g_task_new(NULL, NULL, on_prefetch_done, NULL);
+    g_task_set_task_data(task, execs, (GDestroyNotify)g_ptr_array_unref);
+    g_task_run_in_thread(task, prefetch_thread);
+    g_object_unref(task);
+}
+
+static void free_launch_history(void)
+{
+    g_clear_pointer(&g_launch_history, g_array_unref);
+    g_clear_pointer(&g_launch_queue, g_array_unref);
+    g_clear_pointer(&g_pending_launches, g_array_unref);
+    g_clear_pointer(&g_launched, g_hash_table_destroy);
+    g_clear_pointer(&g_prefetched, g_hash_table_destroy);
+}
+
+/*
+ * Window previews
+ *
+ * Hovering a favorite shows thumbnails of its windows. Each thumbnailed
+ * window is redirected with XComposite and watched with an XDamage object in
+ * ReportNonEmpty mode: the server sends one DamageNotify and then stays
+ * quiet until the damage is subtracted, which only happens when the
+ * thumbnail is redrawn. A window that is not in the open preview therefore
+ * costs at most one event between hovers, and visible ones are redrawn no
+ * more often than every THUMB_MIN_INTERVAL_MS. The X server does the
+ * downscale (XRender via cairo-xlib), so only the small result is read
+ * back. At most THUMB_CACHE_SIZE thumbnails are kept, evicting the least
+ * recently used; minimized windows keep showing their last thumbnail.
+ */
+#define THUMB_WIDTH 160
+#define THUMB_HEIGHT 100
+#define THUMB_CACHE_SIZE 24
+#define THUMB_MIN_INTERVAL_MS 250
+#define PREVIEW_MAX_WINDOWS 6
+
+typedef struct {
+    Window xid;
+    Damage damage;
+    GdkPixbuf *pixbuf;
+    gboolean dirty;     /* damaged since the last downscale */
+    gboolean watched;   /* shown in the open preview */
+    gint64 updated;     /* monotonic time of the last downscale */
+    guint refresh_id;
+    GList *link;        /* node in g_thumb_lru */
+} Thumb;
+
+static Display *g_xdisplay = NULL;
+static int g_damage_event_base = 0;
+static GHashTable *g_thumbs = NULL;         /* Window -> Thumb, owns them */
+static GQueue g_thumb_lru = G_QUEUE_INIT;   /* most recently used first */
+static guint64 g_thumb_damage_events = 0;
+static guint64 g_thumb_refreshes = 0;
+
+static void thumb_free(gpointer data)
+{
+    Thumb *t = data;
+    GdkDisplay *display = gdk_display_get_default();
+
+    if (t->refresh_id) g_source_remove(t->refresh_id);
+    gdk_x11_display_error_trap_push(display);
+    if (t->damage) XDamageDestroy(g_xdisplay, t->damage);
+    XCompositeUnredirectWindow(g_xdisplay, t->xid, CompositeRedirectAutomatic);
+    gdk_x11_display_error_trap_pop_ignored(display);
+    g_clear_object(&t->pixbuf);
+    g_free(t);
+}
+
+/* Downscale the window's current contents into t->pixbuf */
+static gboolean thumb_refresh(Thumb *t)
+{
+    GdkDisplay *display = gdk_display_get_default();
+    XWindowAttributes attr;
+
+    gdk_x11_display_error_trap_push(display);
+    if (!XGetWindowAttributes(g_xdisplay, t->xid, &attr) || attr.map_state != IsViewable ||
+        attr.width <= 0 || attr.height <= 0) {
+        gdk_x11_display_error_trap_pop_ignored(display);
+        return FALSE;
+    }
+    /* Subtract first, so drawing that happens during the copy re-arms it */
+    XDamageSubtract(g_xdisplay, t->damage, None, None);
+    t->dirty = FALSE;
+
+    Pixmap pixmap = XCompositeNameWindowPixmap(g_xdisplay, t->xid);
+    gdouble scale = MIN(1.0, MIN(THUMB_WIDTH / (gdouble)attr.width,
+                                 THUMB_HEIGHT / (gdouble)attr.height));
+    gint tw = MAX(1, (gint)(attr.width * scale));
+    gint th = MAX(1, (gint)(attr.height * scale));
+
+    cairo_surface_t *src = cairo_xlib_surface_create(g_xdisplay, pixmap, attr.visual,
+                                                     attr.width, attr.height);
+    cairo_surface_t *small = cairo_surface_create_similar(src, CAIRO_CONTENT_COLOR_ALPHA, tw, th);
+    cairo_t *cr = cairo_create(small);
+    cairo_scale(cr, scale, scale);
+    cairo_set_source_surface(cr, src, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    GdkPixbuf *pb = gdk_pixbuf_get_from_surface(small, 0, 0, tw, th);
+    cairo_surface_destroy(small);
+    cairo_surface_destroy(src);
+    XFreePixmap(g_xdisplay, pixmap);
+    if (gdk_x11_display_error_trap_pop(display) != 0 || !pb) {
+        g_clear_object(&pb);
+        return FALSE;
+    }
+
+    g_clear_object(&t->pixbuf);
+    t->pixbuf = pb;
+    t->updated = g_get_monotonic_time();
+    g_thumb_refreshes++;
+    return TRUE;
+}
+
+/* The preview image showing xid, if the preview is open */
+static GtkWidget *preview_image_for(Window xid)
+{
+    if (!g_preview) return NULL;
+    GtkWidget *box = gtk_bin_get_child(GTK_BIN(g_preview));
+    GList *children = gtk_container_get_children(GTK_CONTAINER(box));
+    GtkWidget *found = NULL;
+    for (GList *it = children; it && !found; it = it->next) {
+        if (GPOINTER_TO_SIZE(g_object_get_data(G_OBJECT(it->data), "thumb-xid")) == xid)
+            found = it->data;
+    }
+    g_list_free(children);
+    return found;
+}
+
+static gboolean run_thumb_refresh(gpointer data)
+{
+    Thumb *t = data;
+    t->refresh_id = 0;
+    /* The preview closed; the next one downscales dirty thumbnails itself */
+    if (!t->watched) return G_SOURCE_REMOVE;
+    if (t->dirty && thumb_refresh(t)) {
+        GtkWidget *image = preview_image_for(t->xid);
+        if (image) gtk_image_set_from_pixbuf(GTK_IMAGE(image), t->pixbuf);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+/* Redraw a watched thumbnail, at most once per THUMB_MIN_INTERVAL_MS */
+static void thumb_schedule_refresh(Thumb *t)
+{
+    if (t->refresh_id) return;
+    gint64 wait_ms = (t->updated - g_get_monotonic_time()) / 1000 + THUMB_MIN_INTERVAL_MS;
+    if (wait_ms > 0)
+        t->refresh_id = g_timeout_add((guint)wait_ms, run_thumb_refresh, t);
+    else
+        t->refresh_id = g_idle_add(run_thumb_refresh, t);
+}
+
+static GdkFilterReturn thumb_event_filter(GdkXEvent *xevent, GdkEvent *event, gpointer data)
+{
+    XEvent *xev = xevent;
+    if (xev->type != g_damage_event_base + XDamageNotify) return GDK_FILTER_CONTINUE;
+
+    XDamageNotifyEvent *dev = (XDamageNotifyEvent *)xev;
+    Thumb *t = g_hash_table_lookup(g_thumbs, GSIZE_TO_POINTER(dev->drawable));
+    g_thumb_damage_events++;
+    if (t) {
+        t->dirty = TRUE;
+        if (t->watched) thumb_schedule_refresh(t);
+    }
+    return GDK_FILTER_REMOVE;
+}
+
+/* Look for XComposite >= 0.2 and XDamage once. Returns FALSE when previews
+ * are unavailable (not on X11, or an extension is missing). */
+static gboolean thumbs_init(void)
+{
+    static gint state = 0;  /* 0 unknown, 1 supported, -1 not */
+    if (state) return state > 0;
+    state = -1;
+
+    GdkDisplay *display = gdk_display_get_default();
+    if (!GDK_IS_X11_DISPLAY(display)) return FALSE;
+    g_xdisplay = GDK_DISPLAY_XDISPLAY(display);
+
+    int event_base, error_base, major = 0, minor = 2;
+    if (!XCompositeQueryExtension(g_xdisplay, &event_base, &error_base) ||
+        !XCompositeQueryVersion(g_xdisplay, &major, &minor) ||
+        (major == 0 && minor < 2)) {
+        g_debug("previews: XComposite 0.2 not available");
+        return FALSE;
+    }
+    if (!XDamageQueryExtension(g_xdisplay, &g_damage_event_base, &error_base)) {
+        g_debug("previews: XDamage not available");
+        return FALSE;
+    }
+
+    g_thumbs = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, thumb_free);
+    gdk_window_add_filter(NULL, thumb_event_filter, NULL);
+    state = 1;
+    return TRUE;
+}
+
+/* Cached thumbnail for xid, created on first use and moved to the LRU front */
+static Thumb *thumb_get(Window xid)
+{
+    Thumb *t = g_hash_table_lookup(g_thumbs, GSIZE_TO_POINTER(xid));
+    if (t) {
+        g_queue_unlink(&g_thumb_lru, t->link);
+        g_queue_push_head_link(&g_thumb_lru, t->link);
+        return t;
+    }
+
+    GdkDisplay *display = gdk_display_get_default();
+    t = g_new0(Thumb, 1);
+    t->xid = xid;
+    t->dirty = TRUE;
+    gdk_x11_display_error_trap_push(display);
+    XCompositeRedirectWindow(g_xdisplay, xid, CompositeRedirectAutomatic);
+    t->damage = XDamageCreate(g_xdisplay, xid, XDamageReportNonEmpty);
+    if (gdk_x11_display_error_trap_pop(display) != 0) {
+        thumb_free(t);
+        return NULL;
+    }
+    g_queue_push_head(&g_thumb_lru, t);
+    t->link = g_thumb_lru.head;
+    g_hash_table_insert(g_thumbs, GSIZE_TO_POINTER(xid), t);
+
+    while (g_thumb_lru.length > THUMB_CACHE_SIZE) {
+        Thumb *old = g_queue_pop_tail(&g_thumb_lru);
+        g_hash_table_remove(g_thumbs, GSIZE_TO_POINTER(old->xid));
+    }
+    return t;
+}
+
+/* Drop the thumbnail of a closed window */
+static void thumb_forget(Window xid)
+{
+    Thumb *t = g_thumbs ? g_hash_table_lookup(g_thumbs, GSIZE_TO_POINTER(xid)) : NULL;
+    if (!t) return;
+    g_queue_delete_link(&g_thumb_lru, t->link);
+    g_hash_table_remove(g_thumbs, GSIZE_TO_POINTER(xid));
+}
+
+static void on_preview_destroy(GtkWidget *preview, gpointer data)
+{
+    GtkWidget *box = gtk_bin_get_child(GTK_BIN(preview));
+    GList *children = box ? gtk_container_get_children(GTK_CONTAINER(box)) : NULL;
+    for (GList *it = children; it; it = it->next) {
+        Window xid = GPOINTER_TO_SIZE(g_object_get_data(G_OBJECT(it->data), "thumb-xid"));
+        Thumb *t = g_hash_table_lookup(g_thumbs, GSIZE_TO_POINTER(xid));
+        if (!t) continue;
+        t->watched = FALSE;
+        if (t->refresh_id) {
+            g_source_remove(t->refresh_id);
+            t->refresh_id = 0;
+        }
+    }
+    g_list_free(children);
+    g_preview = NULL;
+}
+
+/* Pop up thumbnails of a favorite's windows above its dock button */
+static void show_window_preview(GtkWidget *btn, gint slot)
+{
+    if (!g_wnck_screen || !thumbs_init()) return;
+
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);
+    guint shown = 0;
+    for (GList *l = wnck_screen_get_windows(g_wnck_screen);
+         l && shown < PREVIEW_MAX_WINDOWS; l = l->next) {
+        WnckWindow *win = l->data;
+        if (wnck_window_is_skip_tasklist(win) || favorite_for_window(win) != slot) continue;
+        Thumb *t = thumb_get(wnck_window_get_xid(win));
+        if (!t) continue;
+        if (t->dirty) thumb_refresh(t);
+        if (!t->pixbuf) continue;
+
+        GtkWidget *image = gtk_image_new_from_pixbuf(t->pixbuf);
+        gtk_widget_set_tooltip_text(image, wnck_window_get_name(win));
+        g_object_set_data(G_OBJECT(image), "thumb-xid", GSIZE_TO_POINTER(t->xid));
+        gtk_container_add(GTK_CONTAINER(box), image);
+        t->watched = TRUE;
+        shown++;
+    }
+
+    g_preview = gtk_popover_new(btn);
+    gtk_popover_set_modal(GTK_POPOVER(g_preview), FALSE);
+    gtk_popover_set_position(GTK_POPOVER(g_preview), GTK_POS_TOP);
+    gtk_container_add(GTK_CONTAINER(g_preview), box);
+    g_signal_connect(g_preview, "destroy", G_CALLBACK(on_preview_destroy), NULL);
+    if (shown == 0) {
+        gtk_widget_destroy(g_preview);
+        return;
+    }
+    gtk_widget_show_all(box);
+    gtk_popover_popup(GTK_POPOVER(g_preview));
+}
+
+static gboolean on_dock_button_crossing(GtkWidget *btn, GdkEventCrossing *event, gpointer data)
+{
+    if (event->detail == GDK_NOTIFY_INFERIOR) return FALSE;
+    if (g_preview) gtk_widget_destroy(g_preview);
+    if (event->type == GDK_ENTER_NOTIFY) {
+        gint slot = (gint)GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(btn), "favorite-index")) - 1;
+        if (slot >= 0) show_window_preview(btn, slot);
+    }
+    return FALSE;
+}
+
+static void free_thumbs(void)
+{
+    if (g_preview) gtk_widget_destroy(g_preview);
+    if (!g_thumbs) return;
+    gdk_window_remove_filter(NULL, thumb_event_filter, NULL);
+    g_queue_clear(&g_thumb_lru);
+    g_clear_pointer(&g_thumbs, g_hash_table_destroy);
+}
+
+static void on_window_opened(WnckScreen *screen, WnckWindow *window, gpointer data)
+{
+    on_launch_window_opened(window);
+    on_window_state_changed(screen, window, data);
+}
+
+static void on_window_closed(WnckScreen *screen, WnckWindow *window, gpointer data)
+{
+    if (window) thumb_forget(wnck_window_get_xid(window));
+    on_window_state_changed(screen, window, data);
+}
+
+/*
+ * Staged startup: main() only builds the dock bar from cached favorites.
+ * The phases below run one after another in idle time, starting after the
+ * frame clock has painted the bar's first frame, so first paint does not
+ * depend on the number of open windows or installed applications. Each
+ * phase may return TRUE to be called again (used to split long work into
+ * slices).
+ */
+typedef struct {
+    const char *name;
+    gboolean (*run)(void);
+} StartupPhase;
+
+static gint64 g_startup_begin = 0;
+
+static gboolean startup_init_wnck(void)
+{
+    WnckHandle *handle = wnck_handle_new(WNCK_CLIENT_TYPE_APPLICATION);
+    g_wnck_screen = wnck_handle_get_default_screen(handle);
+    wnck_screen_force_update(g_wnck_screen);
+    g_signal_connect(G_OBJECT(g_wnck_screen), "window-opened",
+                    G_CALLBACK(on_window_opened), NULL);
+    g_signal_connect(G_OBJECT(g_wnck_screen), "window-closed",
+                    G_CALLBACK(on_window_closed), NULL);
+    return FALSE;
+}
+
+/* Index the installed applications, 64 directory entries per call, then
+ * watch their directories */
+static gboolean startup_load_app_index(void)
+{
+    if (load_desktop_entries_step(64)) return TRUE;
+    watch_application_dirs();
+    return FALSE;
+}
+
+/* Warm the icon theme index and the page cache for launcher icons */
+static gboolean startup_prefetch_icons(void)
+{
+    static guint next = 0;
+    const guint slice = 16;
+    GtkIconTheme *theme = gtk_icon_theme_get_default();
+    GdkMonitor *monitor = gdk_display_get_primary_monitor(gdk_display_get_default());
+    gint scale = monitor ? gdk_monitor_get_scale_factor(monitor) : 1;
+
+    if (!g_app_entries || !theme) return FALSE;
+    for (guint n = 0; n < slice && next < g_app_entries->len; ++n, ++next) {
+        AppEntry *ae = &g_array_index(g_app_entries, AppEntry, next);
+        if (!ae->icon || !*ae->icon || g_path_is_absolute(ae->icon)) continue;
+        GtkIconInfo *info = gtk_icon_theme_lookup_icon_for_scale(theme, ae->icon, 48, scale, 0);
+        if (!info) continue;
+        GdkPixbuf *pb = gtk_icon_info_load_icon(info, NULL);
+        if (pb) g_object_unref(pb);
+        g_object_unref(info);
+    }
+    return next < g_app_entries->len;
+}
+
+/* Read the sample rate, watch the screensaver and input idleness and start
+ * sampling */
+static gboolean startup_init_app_sampler(void)
+{
+    const char *interval = g_getenv("DOCK_SAMPLE_INTERVAL");
+    if (interval) g_sample_interval = (guint)g_ascii_strtoull(interval, NULL, 10);
+    if (!g_sample_interval) return FALSE;
+
+    GdkDisplay *display = gdk_display_get_default();
+    if (GDK_IS_X11_DISPLAY(display)) {
+        int event_base, error_base;
+        g_have_idle_query = XScreenSaverQueryExtension(GDK_DISPLAY_XDISPLAY(display),
+                                                       &event_base, &error_base);
+    }
+
+    g_session_bus = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, NULL);
+    if (g_session_bus) {
+        static const char *ifaces[] = { "org.freedesktop.ScreenSaver", "org.gnome.ScreenSaver" };
+        for (guint i = 0; i < G_N_ELEMENTS(ifaces); ++i)
+            g_screensaver_watch[i] = g_dbus_connection_signal_subscribe(
+                g_session_bus, NULL, ifaces[i], "ActiveChanged", NULL, NULL,
+                G_DBUS_SIGNAL_FLAGS_NONE, on_screensaver_active_changed, NULL, NULL);
+    }
+    update_app_sampler();
+    return FALSE;
+}
+
+/* Build the launcher window hidden, a slice of buttons per call */
+static gboolean startup_build_launcher(void)
+{
+    if (!g_app_entries || !g_dock_box) return FALSE;
+    build_app_launcher(GTK_WINDOW(gtk_widget_get_toplevel(g_dock_box)));
+    return sync_launcher_entries(32);
+}
+
+static gboolean startup_prefetch_apps(void)
+{
+    prefetch_top_apps();
+    return FALSE;
+}
+
+static const StartupPhase g_startup_phases[] = {
+    { "wnck", startup_init_wnck },
+    { "app-sampler", startup_init_app_sampler },
+    { "app-index", startup_load_app_index },
+    { "launcher-icons", startup_prefetch_icons },
+    { "launcher", startup_build_launcher },
+    { "prefetch-apps", startup_prefetch_apps },
+};
+
+static gboolean run_startup_phase(gpointer user_data)
+{
+    static guint phase = 0;
+    static gint64 phase_time = 0;
+    (void)user_data;
+
+    if (phase >= G_N_ELEMENTS(g_startup_phases)) return G_SOURCE_REMOVE;
+
+    const StartupPhase *p = &g_startup_phases[phase];
+    gint64 start = g_get_monotonic_time();
+    gboolean more = p->run();
+    phase_time += g_get_monotonic_time() - start;
+    if (more) return G_SOURCE_CONTINUE;
+
+    g_debug("startup: %s took %.2f ms (done at t+%.2f ms)", p->name,
+            phase_time / 1000.0, (g_get_monotonic_time() - g_startup_begin) / 1000.0);
+    phase_time = 0;
+    ++phase;
+    return phase < G_N_ELEMENTS(g_startup_phases) ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+/* The dock bar's first frame is painted: log it and queue the phases */
+static void on_first_after_paint(GdkFrameClock *clock, gpointer user_data)
+{
+    g_signal_handlers_disconnect_by_func(clock, on_first_after_paint, user_data);
+    g_debug("startup: first paint at %.2f ms",
+            (g_get_monotonic_time() - g_startup_begin) / 1000.0);
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, run_startup_phase, NULL, NULL);
+}
+
+static void start_phases_after_first_paint(GtkWidget *window)
+{
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(window);
+    if (clock)
+        g_signal_connect(clock, "after-paint", G_CALLBACK(on_first_after_paint), NULL);
+    else
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, run_startup_phase, NULL, NULL);
+}
+
+/* Build and show the dock window with its favorites bar */
+static GtkWidget *create_dock_window(void)
+{
     /* Create top-level window */
     GtkWidget *window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
     gtk_window_set_decorated(GTK_WINDOW(window), FALSE);
@@ -702,6 +2701,13 @@ int main(int argc, char **argv)
         ".flash {"
         "  background-color: rgba(255,255,255,0.3);"
         "  opacity: 0.8;"
+        "}"
+        ".badge {"
+        "  font-size: 8px;"
+        "  color: white;"
+        "  background-color: rgba(0,0,0,0.6);"
+        "  border-radius: 6px;"
+        "  padding: 0 3px;"
         "}";
     gtk_css_provider_load_from_data(css, style, -1, NULL);
     gtk_style_context_add_provider_for_screen(screen, GTK_STYLE_PROVIDER(css), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
@@ -743,7 +2749,12 @@ int main(int argc, char **argv)
     /* Keep decorations off for nicer look */
     gtk_widget_set_app_paintable(window, TRUE);
 
-    g_signal_connect(window, "destroy", G_CALLBACK(gtk_main_quit), NULL);
+    /* The usage badges stop sampling while the dock is not on screen */
+    g_signal_connect(window, "map-event", G_CALLBACK(on_dock_map_changed), NULL);
+    g_signal_connect(window, "unmap-event", G_CALLBACK(on_dock_map_changed), NULL);
+    g_signal_connect(window, "window-state-event", G_CALLBACK(on_dock_state_changed), NULL);
+    gtk_widget_add_events(window, GDK_VISIBILITY_NOTIFY_MASK);
+    g_signal_connect(window, "visibility-notify-event", G_CALLBACK(on_dock_visibility_changed), NULL);
 
     /* Create favorites bar */
     g_dock_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
@@ -752,11 +2763,64 @@ int main(int argc, char **argv)
     update_favorites_bar();
 
     gtk_widget_show_all(window);
-    gtk_main();
+    return window;
+}
 
-    /* Cleanup */
+/* Release the app model on exit */
+static void dock_cleanup(void)
+{
+    if (g_favorites_update_id) {
+        g_source_remove(g_favorites_update_id);
+        g_favorites_update_id = 0;
+    }
+    if (g_flash_timer_id) {
+        g_source_remove(g_flash_timer_id);
+        g_flash_timer_id = 0;
+    }
+    if (g_launcher_window)
+        gtk_widget_destroy(g_launcher_window);
+    free_app_sampler();
+    free_application_watch();
+    free_thumbs();
+    free_launch_history();
+    if (g_flashing) {
+        g_ptr_array_free(g_flashing, TRUE);
+        g_flashing = NULL;
+    }
     if (g_favorites) {
-        g_ptr_array_unref(g_favorites); 
+        g_array_unref(g_favorites);
+        g_favorites = NULL;
     }
+    free_app_entries();
+    free_model_strings();
+}
+
+/* Benchmarks include this file directly and provide their own main() */
+#ifndef DOCK_NO_MAIN
+int main(int argc, char **argv)
+{
+    gtk_init(&argc, &argv);
+    gdk_set_program_class("dock");
+    
+    g_startup_begin = g_get_monotonic_time();
+
+    /* Load favorites (cached config only; needed for first paint) */
+    load_favorites();
+
+    GtkWidget *window = create_dock_window();
+    g_signal_connect(window, "destroy", G_CALLBACK(gtk_main_quit), NULL);
+    g_debug("startup: dock bar built in %.2f ms",
+            (g_get_monotonic_time() - g_startup_begin) / 1000.0);
+
+    /* SIGUSR1 logs the model's memory footprint and wakeups per second */
+    install_wakeup_counter();
+    g_unix_signal_add(SIGUSR1, on_report_model_signal, NULL);
+
+    /* Everything else runs in idle time after the dock bar is on screen */
+    start_phases_after_first_paint(window);
+    gtk_main();
+
+    dock_cleanup();
     return 0;
 }
+#endif /* DOCK_NO_MAIN */
@@ -0,0 +1,71 @@
+#include "alloc_count.h"
+
+#include <errno.h>
+
+/* Interpose malloc for every library in the process and forward to glibc.
+ * glibc has no __libc_ entry for posix_memalign or aligned_alloc; both go
+ * through __libc_memalign. The counters are updated from any thread
+ * (GTask workers, GDK's X thread), so they are relaxed atomics. */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+size_t alloc_count_calls = 0;
+size_t alloc_count_bytes = 0;
+long alloc_count_live = 0;
+
+static void count_alloc(size_t bytes, long live)
+{
+    __atomic_fetch_add(&alloc_count_calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&alloc_count_bytes, bytes, __ATOMIC_RELAXED);
+    if (live) __atomic_fetch_add(&alloc_count_live, live, __ATOMIC_RELAXED);
+}
+
+void *malloc(size_t size)
+{
+    count_alloc(size, 1);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size)
+{
+    count_alloc(n * size, 1);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    count_alloc(size, !ptr ? 1 : size == 0 ? -1 : 0);
+    return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    count_alloc(size, 1);
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    count_alloc(size, 1);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0)
+        return EINVAL;
+    count_alloc(size, 1);
+    void *p = __libc_memalign(alignment, size);
+    if (!p) return ENOMEM;
+    *memptr = p;
+    return 0;
+}
+
+void free(void *ptr)
+{
+    if (ptr) __atomic_fetch_sub(&alloc_count_live, 1, __ATOMIC_RELAXED);
+    __libc_free(ptr);
+}
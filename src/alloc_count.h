@@ -0,0 +1,14 @@
+#ifndef ALLOC_COUNT_H
+#define ALLOC_COUNT_H
+
+#include <stddef.h>
+
+/* Process-wide allocation counters, maintained by the malloc interposers in
+ * alloc_count.c (malloc, calloc, realloc, free and the aligned variants).
+ * Updated with relaxed atomics. Only linked into the benchmark and stress
+ * tools. */
+extern size_t alloc_count_calls;   /* malloc/calloc/realloc/memalign calls */
+extern size_t alloc_count_bytes;   /* bytes requested by those calls */
+extern long alloc_count_live;      /* blocks allocated minus blocks freed */
+
+#endif
@@ -0,0 +1,552 @@
+/*
+ * Offline benchmarks for the dock's hot paths
+ *
+ * Generates a synthetic applications directory and a synthetic icon theme,
+ * then times parse_desktop_file, load_all_desktop_entries, smart_match,
+ * on_search_changed and get_icon_path against them, opening the pre-built
+ * launcher, plus one /proc sample of the app usage sampler. Each benchmark prints
+ * one JSON object per line with latency percentiles and allocation counts
+ * (see alloc_count.c).
+ *
+ * With --launch CMD it instead times how long CMD takes to map its first
+ * window, alternating runs with its program and libraries evicted from the
+ * page cache (posix_fadvise DONTNEED) and runs where they were then read
+ * ahead by the dock's prefetch code, and prints one JSON line comparing
+ * the two. Files still mapped by other processes (libc, GTK) cannot be
+ * evicted, so the cold runs are as cold as the kernel allows, not a reboot.
+ * Single-instance apps that hand off to a running copy cannot be timed.
+ *
+ * Needs a display for GTK; run it headless, e.g.:
+ *   xvfb-run ./dock_bench --apps 5000
+ *   broadwayd :5 & GDK_BACKEND=broadway BROADWAY_DISPLAY=:5 ./dock_bench
+ *
+ * XDG_DATA_HOME and XDG_DATA_DIRS point into the corpus, so only the
+ * synthetic applications are scanned (plus the Flatpak/Snap export
+ * directories, if the machine has them).
+ */
+
+#define DOCK_NO_MAIN
+#include "../main.c"
+#include "icon_loader.h"
+#include "alloc_count.h"
+
+#include <glib/gstdio.h>
+#include <sys/wait.h>
+
+/* Options */
+static gint opt_apps = 1000;
+static gint opt_icons = 500;
+static gint opt_iterations = 20;
+static gchar *opt_corpus = NULL;
+static gboolean opt_keep = FALSE;
+static gchar *opt_launch = NULL;
+
+static GOptionEntry bench_options[] = {
+    { "apps", 'a', 0, G_OPTION_ARG_INT, &opt_apps, "Number of .desktop files to generate", "N" },
+    { "icons", 'i', 0, G_OPTION_ARG_INT, &opt_icons, "Number of distinct app icons in the theme", "N" },
+    { "iterations", 'n', 0, G_OPTION_ARG_INT, &opt_iterations, "Timed iterations per benchmark", "N" },
+    { "corpus", 'c', 0, G_OPTION_ARG_FILENAME, &opt_corpus, "Directory for the synthetic corpus", "DIR" },
+    { "keep", 'k', 0, G_OPTION_ARG_NONE, &opt_keep, "Keep the corpus after the run", NULL },
+    { "launch", 'l', 0, G_OPTION_ARG_STRING, &opt_launch,
+      "Time CMD's first window cold and prefetched instead (--iterations runs each)", "CMD" },
+    { NULL }
+};
+
+/* Corpus generation */
+static const char *bench_words[] = {
+    "Text", "Image", "Video", "Music", "Photo", "Code", "Web", "Mail", "Chat",
+    "Office", "Disk", "System", "Network", "Terminal", "Files", "Maps", "Game",
+    "Sound", "Screen", "Font", "Archive", "Calendar", "Clock", "Notes", NULL
+};
+static const char *bench_kinds[] = {
+    "Editor", "Viewer", "Player", "Manager", "Browser", "Client", "Monitor",
+    "Recorder", "Studio", "Tool", "Settings", "Converter", NULL
+};
+static const char *bench_contexts[] = {
+    "apps", "actions", "devices", "categories", "places", "status", "mimetypes", NULL
+};
+static const int bench_sizes[] = { 16, 22, 24, 32, 48, 64, 96, 128, 256, 512 };
+
+/* 1x1 transparent PNG */
+static const guchar bench_png[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+    0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01,
+    0x08, 0x06, 0x00, 0x00, 0x00, 0x1f, 0x15, 0xc4, 0x89, 0x00, 0x00, 0x00,
+    0x0d, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0x63, 0x00, 0x01, 0x00, 0x00,
+    0x05, 0x00, 0x01, 0x0d, 0x0a, 0x2d, 0xb4, 0x00, 0x00, 0x00, 0x00, 0x49,
+    0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+static const char *bench_svg =
+    "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"16\" height=\"16\"/>\n";
+
+/* Icon name used by the i-th app; ~1 in 5 apps share a generic icon */
+static gchar *bench_icon_name(guint i)
+{
+    if (i % 5 == 4) return g_strdup("application-x-executable");
+    return g_strdup_printf("bench-app-%u", i % (guint)opt_icons);
+}
+
+static gchar *bench_app_name(guint i)
+{
+    guint nw = g_strv_length((gchar **)bench_words);
+    guint nk = g_strv_length((gchar **)bench_kinds);
+    return g_strdup_printf("%s %s %u", bench_words[i % nw], bench_kinds[(i / nw) % nk], i);
+}
+
+static void generate_applications(const char *dir)
+{
+    guint nk = g_strv_length((gchar **)bench_kinds);
+    g_mkdir_with_parents(dir, 0755);
+    for (guint i = 0; i < (guint)opt_apps; ++i) {
+        gchar *name = bench_app_name(i);
+        gchar *icon = bench_icon_name(i);
+        gchar *content = g_strdup_printf(
+            "[Desktop Entry]\n"
+            "Type=Application\n"
+            "Name=%s\n"
+            "Name[de]=%s (de)\n"
+            "Name[fr]=%s (fr)\n"
+            "GenericName=%s\n"
+            "Comment=Synthetic application number %u for benchmarks\n"
+            "Exec=/usr/bin/bench-app-%u --new-window %%U\n"
+            "Icon=%s\n"
+            "Terminal=false\n"
+            "Categories=Utility;Development;\n"
+            "Keywords=bench;synthetic;%s;\n"
+            "%s"
+            "\n"
+            "[Desktop Action new-window]\n"
+            "Name=New Window\n"
+            "Exec=/usr/bin/bench-app-%u --new-window\n",
+            name, name, name, bench_kinds[i % nk], i, i, icon, name,
+            i % 17 == 0 ? "NoDisplay=true\n" : "",
+            i);
+        gchar *file = g_strdup_printf("%s/bench-app-%u.desktop", dir, i);
+        g_file_set_contents(file, content, -1, NULL);
+        g_free(file);
+        g_free(content);
+        g_free(icon);
+        g_free(name);
+    }
+}
+
+static void write_icon(const char *dir, const char *name, gboolean svg)
+{
+    gchar *file = g_strdup_printf("%s/%s.%s", dir, name, svg ? "svg" : "png");
+    if (svg)
+        g_file_set_contents(file, bench_svg, -1, NULL);
+    else
+        g_file_set_contents(file, (const gchar *)bench_png, sizeof bench_png, NULL);
+    g_free(file);
+}
+
+/* A theme with every size x context directory, like real themes */
+static void generate_icon_theme(const char *theme_dir)
+{
+    GString *index = g_string_new("[Icon Theme]\nName=vaxp-bench\nComment=Synthetic\nDirectories=");
+    GString *sections = g_string_new("");
+
+    for (guint s = 0; s <= G_N_ELEMENTS(bench_sizes); ++s) {
+        gboolean scalable = (s == G_N_ELEMENTS(bench_sizes));
+        gchar *size_dir = scalable ? g_strdup("scalable")
+                                   : g_strdup_printf("%dx%d", bench_sizes[s], bench_sizes[s]);
+        for (const char **ctx = bench_contexts; *ctx; ++ctx) {
+            gchar *rel = g_strdup_printf("%s/%s", size_dir, *ctx);
+            gchar *dir = g_build_filename(theme_dir, rel, NULL);
+            g_mkdir_with_parents(dir, 0755);
+
+            /* apps gets every icon; other contexts get filler for depth */
+            guint count = g_strcmp0(*ctx, "apps") == 0 ? (guint)opt_icons : 50;
+            for (guint i = 0; i < count; ++i) {
+                gchar *name = g_strcmp0(*ctx, "apps") == 0
+                    ? g_strdup_printf("bench-app-%u", i)
+                    : g_strdup_printf("bench-%s-%u", *ctx, i);
+                write_icon(dir, name, scalable);
+                g_free(name);
+            }
+            if (g_strcmp0(*ctx, "apps") == 0 && !scalable)
+                write_icon(dir, "application-x-executable", FALSE);
+
+            g_string_append_printf(index, "%s,", rel);
+            if (scalable)
+                g_string_append_printf(sections, "\n[%s]\nSize=48\nMinSize=8\nMaxSize=512\nType=Scalable\n", rel);
+            else
+                g_string_append_printf(sections, "\n[%s]\nSize=%d\nType=Fixed\n", rel, bench_sizes[s]);
+            g_free(dir);
+            g_free(rel);
+        }
+        g_free(size_dir);
+    }
+
+    g_string_truncate(index, index->len - 1);
+    g_string_append_c(index, '\n');
+    g_string_append(index, sections->str);
+    gchar *file = g_build_filename(theme_dir, "index.theme", NULL);
+    g_file_set_contents(file, index->str, -1, NULL);
+    g_free(file);
+    g_string_free(sections, TRUE);
+    g_string_free(index, TRUE);
+}
+
+static void remove_tree(const char *path)
+{
+    GDir *dir = g_dir_open(path, 0, NULL);
+    if (dir) {
+        const char *name;
+        while ((name = g_dir_read_name(dir))) {
+            gchar *child = g_build_filename(path, name, NULL);
+            remove_tree(child);
+            g_free(child);
+        }
+        g_dir_close(dir);
+    }
+    g_remove(path);
+}
+
+/* Timing */
+static gint compare_samples(gconstpointer a, gconstpointer b)
+{
+    gint64 x = *(const gint64 *)a, y = *(const gint64 *)b;
+    return x < y ? -1 : x > y;
+}
+
+/* Run fn opt_iterations times and print one JSON line.
+ * ops is the number of items each call processes. */
+static void bench_run(const char *name, guint ops, void (*fn)(gpointer), gpointer data)
+{
+    GArray *samples = g_array_sized_new(FALSE, FALSE, sizeof(gint64), opt_iterations);
+    gsize allocs = 0, bytes = 0;
+    gint64 total = 0;
+
+    for (gint i = 0; i < opt_iterations; ++i) {
+        gsize a0 = alloc_count_calls, b0 = alloc_count_bytes;
+        gint64 t0 = g_get_monotonic_time();
+        fn(data);
+        gint64 dt = g_get_monotonic_time() - t0;
+        allocs += alloc_count_calls - a0;
+        bytes += alloc_count_bytes - b0;
+        total += dt;
+        g_array_append_val(samples, dt);
+    }
+
+    gint64 cold = g_array_index(samples, gint64, 0);
+    g_array_sort(samples, compare_samples);
+    guint n = samples->len;
+    gdouble per_run_ops = (gdouble)opt_iterations * MAX(ops, 1);
+    printf("{\"bench\":\"%s\",\"ops\":%u,\"iterations\":%u,"
+           "\"cold_us\":%" G_GINT64_FORMAT ",\"mean_us\":%.1f,"
+           "\"p50_us\":%" G_GINT64_FORMAT ",\"p95_us\":%" G_GINT64_FORMAT ",\"max_us\":%" G_GINT64_FORMAT ","
+           "\"ns_per_op\":%.1f,\"allocs_per_op\":%.2f,\"alloc_bytes_per_op\":%.1f}\n",
+           name, ops, n, cold, (gdouble)total / n,
+           g_array_index(samples, gint64, n / 2),
+           g_array_index(samples, gint64, MIN(n - 1, (n * 95) / 100)),
+           g_array_index(samples, gint64, n - 1),
+           total * 1000.0 / per_run_ops, allocs / per_run_ops, bytes / per_run_ops);
+    fflush(stdout);
+    g_array_free(samples, TRUE);
+}
+
+/* Benchmarks */
+typedef struct {
+    GPtrArray *files;       /* synthetic .desktop paths */
+    GPtrArray *icons;       /* icon names to resolve */
+    GtkWidget *flow;        /* launcher-like flow box */
+    GtkWidget *search;
+} BenchCtx;
+
+static const char *bench_queries[] = { "t", "te", "tex", "text ed", "edi", "player 1", "zzz", "", NULL };
+
+static void bench_parse(gpointer data)
+{
+    BenchCtx *ctx = data;
+    for (guint i = 0; i < ctx->files->len; ++i) {
+        AppEntry e;
+        parse_desktop_file(g_ptr_array_index(ctx->files, i), &e);
+    }
+    free_model_strings();
+}
+
+static void bench_load_all(gpointer data)
+{
+    (void)data;
+    free_app_entries();
+    free_model_strings();
+    load_all_desktop_entries();
+}
+
+static void bench_smart_match(gpointer data)
+{
+    (void)data;
+    for (const char **q = bench_queries; *q; ++q) {
+        for (guint i = 0; i < g_app_entries->len; ++i)
+            smart_match(app_entry_label(&g_array_index(g_app_entries, AppEntry, i)), *q);
+    }
+}
+
+static void bench_search_changed(gpointer data)
+{
+    BenchCtx *ctx = data;
+    for (const char **q = bench_queries; *q; ++q) {
+        gtk_entry_set_text(GTK_ENTRY(ctx->search), *q);
+        on_search_changed(GTK_SEARCH_ENTRY(ctx->search), ctx->flow);
+    }
+}
+
+static void bench_icon_path(gpointer data)
+{
+    BenchCtx *ctx = data;
+    for (guint i = 0; i < ctx->icons->len; ++i)
+        free_icon_path(get_icon_path(g_ptr_array_index(ctx->icons, i), 48));
+}
+
+static void bench_launcher_open(gpointer data)
+{
+    (void)data;
+    show_app_launcher(NULL);
+    gtk_widget_hide(g_launcher_window);
+}
+
+static void bench_scan_processes(gpointer data)
+{
+    (void)data;
+    scan_processes();
+    account_app_usage();
+}
+
+/* Launch benchmark */
+typedef struct {
+    const char *exec;
+    GMainLoop *loop;
+    guint timeout_id;
+    gboolean mapped;
+} LaunchWait;
+
+static void on_bench_window_opened(WnckScreen *screen, WnckWindow *win, gpointer data)
+{
+    LaunchWait *w = data;
+    if (!window_runs_exec(win, w->exec)) return;
+    w->mapped = TRUE;
+    g_main_loop_quit(w->loop);
+}
+
+static gboolean on_bench_launch_timeout(gpointer data)
+{
+    LaunchWait *w = data;
+    w->timeout_id = 0;
+    g_main_loop_quit(w->loop);
+    return G_SOURCE_REMOVE;
+}
+
+/* Drop the files in the set from the page cache, as far as the kernel will */
+static void evict_files(GHashTable *files)
+{
+    GHashTableIter it;
+    gpointer path;
+    g_hash_table_iter_init(&it, files);
+    while (g_hash_table_iter_next(&it, &path, NULL)) {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+/* Spawn exec and return the microseconds until its first window maps, or
+ * -1 if it did not within LAUNCH_TIMEOUT_US. The process is killed after. */
+static gint64 time_launch(WnckScreen *screen, const char *exec)
+{
+    gchar **argv = NULL;
+    if (!g_shell_parse_argv(exec, NULL, &argv, NULL)) return -1;
+
+    LaunchWait w = { exec, g_main_loop_new(NULL, FALSE), 0, FALSE };
+    gulong handler = g_signal_connect(screen, "window-opened", G_CALLBACK(on_bench_window_opened), &w);
+    gint64 dt = -1;
+    GPid pid;
+    gint64 t0 = g_get_monotonic_time();
+    if (g_spawn_async(NULL, argv, NULL, G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
+                      NULL, NULL, &pid, NULL)) {
+        w.timeout_id = g_timeout_add(LAUNCH_TIMEOUT_US / 1000, on_bench_launch_timeout, &w);
+        g_main_loop_run(w.loop);
+        if (w.mapped) dt = g_get_monotonic_time() - t0;
+        if (w.timeout_id) g_source_remove(w.timeout_id);
+        kill(pid, SIGTERM);
+        waitpid(pid, NULL, 0);
+        g_spawn_close_pid(pid);
+    }
+    g_signal_handler_disconnect(screen, handler);
+    g_main_loop_unref(w.loop);
+    g_strfreev(argv);
+
+    /* let the closed window's events through before the next run */
+    g_usleep(200 * 1000);
+    while (g_main_context_iteration(NULL, FALSE))
+        ;
+    return dt;
+}
+
+static gint64 median_us(GArray *samples)
+{
+    if (samples->len == 0) return -1;
+    g_array_sort(samples, compare_samples);
+    return g_array_index(samples, gint64, samples->len / 2);
+}
+
+/* Time opt_launch cold and prefetched, alternating, and print one JSON line */
+static int bench_launch(void)
+{
+    gchar *prog = program_path_for_exec(opt_launch);
+    if (!prog) {
+        fprintf(stderr, "--launch: cannot find the program of \"%s\"\n", opt_launch);
+        return 1;
+    }
+    WnckHandle *handle = wnck_handle_new(WNCK_CLIENT_TYPE_APPLICATION);
+    WnckScreen *screen = wnck_handle_get_default_screen(handle);
+    wnck_screen_force_update(screen);
+
+    /* The files a prefetch of this command reads, and their size */
+    Prefetch files = { g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL),
+                       library_dirs(), 0, 0 };
+    prefetch_file(&files, prog, 0);
+
+    GArray *cold = g_array_new(FALSE, FALSE, sizeof(gint64));
+    GArray *warm = g_array_new(FALSE, FALSE, sizeof(gint64));
+    for (gint i = 0; i < opt_iterations; ++i) {
+        evict_files(files.seen);
+        gint64 dt = time_launch(screen, opt_launch);
+        if (dt >= 0) g_array_append_val(cold, dt);
+
+        evict_files(files.seen);
+        Prefetch pf = { g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL),
+                        library_dirs(), 0, 0 };
+        prefetch_file(&pf, prog, 0);
+        g_ptr_array_free(pf.lib_dirs, TRUE);
+        g_hash_table_destroy(pf.seen);
+        dt = time_launch(screen, opt_launch);
+        if (dt >= 0) g_array_append_val(warm, dt);
+    }
+
+    guint timed_cold = cold->len, timed_warm = warm->len;
+    gint64 cold_us = median_us(cold), warm_us = median_us(warm);
+    printf("{\"bench\":\"launch\",\"files\":%u,\"bytes\":%" G_GUINT64_FORMAT ","
+           "\"cold_runs\":%u,\"prefetched_runs\":%u,"
+           "\"cold_p50_us\":%" G_GINT64_FORMAT ",\"prefetched_p50_us\":%" G_GINT64_FORMAT "}\n",
+           files.files, files.bytes, timed_cold, timed_warm, cold_us, warm_us);
+    fflush(stdout);
+    if (!timed_cold || !timed_warm)
+        fprintf(stderr, "--launch: no window of \"%s\" mapped within %d s\n", opt_launch,
+                (int)(LAUNCH_TIMEOUT_US / G_USEC_PER_SEC));
+
+    g_array_free(warm, TRUE);
+    g_array_free(cold, TRUE);
+    g_ptr_array_free(files.lib_dirs, TRUE);
+    g_hash_table_destroy(files.seen);
+    g_object_unref(handle);
+    g_free(prog);
+    return timed_cold && timed_warm ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    GError *err = NULL;
+    GOptionContext *octx = g_option_context_new("- benchmark the dock's hot paths");
+    g_option_context_add_main_entries(octx, bench_options, NULL);
+    g_option_context_add_group(octx, gtk_get_option_group(FALSE));
+    if (!g_option_context_parse(octx, &argc, &argv, &err)) {
+        fprintf(stderr, "%s\n", err->message);
+        return 1;
+    }
+    g_option_context_free(octx);
+    if (opt_apps < 1 || opt_icons < 1 || opt_iterations < 1) {
+        fprintf(stderr, "--apps, --icons and --iterations must be positive\n");
+        return 1;
+    }
+
+    if (opt_launch) {
+        if (!gtk_init_check(&argc, &argv)) {
+            fprintf(stderr, "Failed to initialize GTK (no display? try xvfb-run or broadwayd)\n");
+            return 1;
+        }
+        return bench_launch();
+    }
+
+    gboolean own_corpus = (opt_corpus == NULL);
+    if (own_corpus)
+        opt_corpus = g_dir_make_tmp("dock-bench-XXXXXX", NULL);
+
+    /* Point the XDG data dirs at the corpus before GLib caches them */
+    gchar *home = g_build_filename(opt_corpus, "data", NULL);
+    gchar *system = g_build_filename(opt_corpus, "system", NULL);
+    gchar *apps_dir = g_build_filename(home, "applications", NULL);
+    gchar *icons_dir = g_build_filename(opt_corpus, "icons", NULL);
+    gchar *theme_dir = g_build_filename(icons_dir, "vaxp-bench", NULL);
+    g_setenv("XDG_DATA_HOME", home, TRUE);
+    g_setenv("XDG_DATA_DIRS", system, TRUE);
+
+    gint64 t0 = g_get_monotonic_time();
+    generate_applications(apps_dir);
+    generate_icon_theme(theme_dir);
+    fprintf(stderr, "corpus: %d apps, %d icons in %s (%.0f ms)\n", opt_apps, opt_icons,
+            opt_corpus, (g_get_monotonic_time() - t0) / 1000.0);
+
+    if (!gtk_init_check(&argc, &argv)) {
+        fprintf(stderr, "Failed to initialize GTK (no display? try xvfb-run or broadwayd)\n");
+        return 1;
+    }
+    GtkIconTheme *theme = gtk_icon_theme_get_default();
+    gtk_icon_theme_prepend_search_path(theme, icons_dir);
+    g_object_set(gtk_settings_get_default(), "gtk-icon-theme-name", "vaxp-bench", NULL);
+
+    BenchCtx ctx = { 0 };
+    ctx.files = g_ptr_array_new_with_free_func(g_free);
+    for (guint i = 0; i < (guint)opt_apps; ++i)
+        g_ptr_array_add(ctx.files, g_strdup_printf("%s/bench-app-%u.desktop", apps_dir, i));
+    ctx.icons = g_ptr_array_new_with_free_func(g_free);
+    for (guint i = 0; i < (guint)opt_apps; ++i)
+        g_ptr_array_add(ctx.icons, bench_icon_name(i));
+
+    bench_run("parse_desktop_file", ctx.files->len, bench_parse, &ctx);
+    bench_run("load_all_desktop_entries", opt_apps, bench_load_all, &ctx);
+    report_model_memory(G_LOG_LEVEL_MESSAGE);
+
+    bench_run("smart_match", g_app_entries->len * g_strv_length((gchar **)bench_queries),
+              bench_smart_match, &ctx);
+
+    ctx.flow = g_object_ref_sink(gtk_flow_box_new());
+    ctx.search = g_object_ref_sink(gtk_search_entry_new());
+    for (guint i = 0; i < g_app_entries->len; ++i) {
+        GtkWidget *btn = gtk_button_new();
+        g_object_set_data(G_OBJECT(btn), "app-index", GUINT_TO_POINTER(i + 1));
+        gtk_container_add(GTK_CONTAINER(ctx.flow), btn);
+    }
+    bench_run("on_search_changed", g_app_entries->len * g_strv_length((gchar **)bench_queries),
+              bench_search_changed, &ctx);
+
+    bench_run("get_icon_path", ctx.icons->len, bench_icon_path, &ctx);
+
+    /* Opening the pre-built launcher should not create any widgets */
+    build_app_launcher(NULL);
+    sync_launcher_entries(G_MAXUINT);
+    bench_run("show_app_launcher", 1, bench_launcher_open, NULL);
+
+    /* One /proc sample; after the first run it should not allocate */
+    bench_run("scan_processes", 1, bench_scan_processes, NULL);
+
+    gtk_widget_destroy(g_launcher_window);
+    g_object_unref(ctx.search);
+    g_object_unref(ctx.flow);
+    g_ptr_array_free(ctx.icons, TRUE);
+    g_ptr_array_free(ctx.files, TRUE);
+    free_app_sampler();
+    free_app_entries();
+    free_model_strings();
+
+    if (own_corpus && !opt_keep)
+        remove_tree(opt_corpus);
+    g_free(theme_dir);
+    g_free(icons_dir);
+    g_free(apps_dir);
+    g_free(system);
+    g_free(home);
+    return 0;
+}
@@ -0,0 +1,270 @@
+/*
+ * Window-event storm and long-run memory check for the dock
+ *
+ * Runs the dock (main.c) and a generator that opens and closes thousands
+ * of windows per minute. Every sampling interval it prints one JSON line
+ * with RSS, live heap blocks, allocation calls and CPU time per window
+ * event. At the end it fails (exit status 1) if RSS or live blocks kept
+ * growing after warm-up, or if the mean CPU cost per event is over budget.
+ *
+ * libwnck only reports windows listed by a window manager, so run it on a
+ * display with one, e.g.:
+ *   xvfb-run -s '-screen 0 1280x800x24' sh -c 'openbox & ./dock_stress'
+ * Without a window manager use --synthetic, which feeds the window-opened
+ * and window-closed handler directly.
+ */
+
+#define DOCK_NO_MAIN
+#include "../main.c"
+#include "alloc_count.h"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+/* Options */
+static gint opt_duration = 60;
+static gint opt_rate = 3000;            /* windows per minute */
+static gint opt_max_open = 16;
+static gint opt_interval = 1;
+static gboolean opt_synthetic = FALSE;
+static gboolean opt_generator = FALSE;
+static gint opt_rss_budget_kb = 4096;
+static gint opt_live_budget = 20000;
+static gint opt_event_budget_us = 1000;
+
+static GOptionEntry stress_options[] = {
+    { "duration", 'd', 0, G_OPTION_ARG_INT, &opt_duration, "Run time in seconds", "S" },
+    { "rate", 'r', 0, G_OPTION_ARG_INT, &opt_rate, "Windows opened per minute", "N" },
+    { "max-open", 'm', 0, G_OPTION_ARG_INT, &opt_max_open, "Windows kept open at once", "N" },
+    { "interval", 'i', 0, G_OPTION_ARG_INT, &opt_interval, "Sampling interval in seconds", "S" },
+    { "synthetic", 's', 0, G_OPTION_ARG_NONE, &opt_synthetic, "Call the event handler directly instead of mapping windows", NULL },
+    { "rss-budget-kb", 0, 0, G_OPTION_ARG_INT, &opt_rss_budget_kb, "Allowed RSS growth after warm-up", "KB" },
+    { "live-budget", 0, 0, G_OPTION_ARG_INT, &opt_live_budget, "Allowed growth in live heap blocks after warm-up", "N" },
+    { "event-budget-us", 0, 0, G_OPTION_ARG_INT, &opt_event_budget_us, "Allowed mean CPU time per window event", "US" },
+    { "generator", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_NONE, &opt_generator, NULL, NULL },
+    { NULL }
+};
+
+/* Generator: opens a window per tick and closes the oldest beyond max-open */
+static GQueue g_generated = G_QUEUE_INIT;
+static guint g_generated_total = 0;
+
+static gboolean generator_tick(gpointer user_data)
+{
+    (void)user_data;
+    GtkWidget *w = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    gchar *title = g_strdup_printf("storm %u", g_generated_total++);
+    gtk_window_set_title(GTK_WINDOW(w), title);
+    g_free(title);
+    gtk_window_set_default_size(GTK_WINDOW(w), 64, 48);
+    gtk_widget_show(w);
+    g_queue_push_tail(&g_generated, w);
+
+    while (g_queue_get_length(&g_generated) > (guint)opt_max_open)
+        gtk_widget_destroy(GTK_WIDGET(g_queue_pop_head(&g_generated)));
+    return G_SOURCE_CONTINUE;
+}
+
+static guint tick_interval_ms(void)
+{
+    return MAX(1, 60000 / MAX(opt_rate, 1));
+}
+
+static int run_generator(void)
+{
+    g_timeout_add(tick_interval_ms(), generator_tick, NULL);
+    gtk_main();
+    return 0;
+}
+
+/* Sampling */
+typedef struct {
+    gdouble t;
+    glong rss_kb;
+    glong live;
+    gdouble cpu_us_per_event;
+} Sample;
+
+static GArray *g_samples = NULL;
+static guint64 g_events = 0;
+static guint64 g_last_events = 0;
+static gint64 g_last_cpu_us = 0;
+static gint64 g_run_begin = 0;
+static GPid g_generator_pid = 0;
+
+static void count_event(WnckScreen *screen, WnckWindow *window, gpointer data)
+{
+    g_events++;
+}
+
+static gboolean synthetic_tick(gpointer user_data)
+{
+    /* one open and one close, as the generator would produce */
+    for (int i = 0; i < 2; ++i) {
+        count_event(g_wnck_screen, NULL, NULL);
+        on_window_state_changed(g_wnck_screen, NULL, NULL);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static glong read_rss_kb(void)
+{
+    glong pages = 0, resident = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static gint64 read_cpu_us(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (gint64)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * G_USEC_PER_SEC
+         + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+
+static gboolean sample_tick(gpointer user_data)
+{
+    (void)user_data;
+    gint64 cpu = read_cpu_us();
+    guint64 events = g_events - g_last_events;
+    Sample s = {
+        (g_get_monotonic_time() - g_run_begin) / (gdouble)G_USEC_PER_SEC,
+        read_rss_kb(),
+        alloc_count_live,
+        events ? (gdouble)(cpu - g_last_cpu_us) / events : 0,
+    };
+    g_array_append_val(g_samples, s);
+    printf("{\"t_s\":%.1f,\"events\":%" G_GUINT64_FORMAT ",\"rss_kb\":%ld,"
+           "\"live_blocks\":%ld,\"alloc_calls\":%zu,\"cpu_us_per_event\":%.1f}\n",
+           s.t, g_events, s.rss_kb, s.live, alloc_count_calls, s.cpu_us_per_event);
+    fflush(stdout);
+
+    if (!opt_synthetic && s.t >= 5 && g_events == 0)
+        g_warning("no window events seen; is a window manager running? (or use --synthetic)");
+
+    g_last_cpu_us = cpu;
+    g_last_events = g_events;
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean stop_run(gpointer user_data)
+{
+    (void)user_data;
+    gtk_main_quit();
+    return G_SOURCE_REMOVE;
+}
+
+static gint compare_glong(gconstpointer a, gconstpointer b)
+{
+    glong x = *(const glong *)a, y = *(const glong *)b;
+    return x < y ? -1 : x > y;
+}
+
+/* Median of one field over samples [from, to) */
+static glong median_of(guint from, guint to, gsize offset)
+{
+    GArray *v = g_array_new(FALSE, FALSE, sizeof(glong));
+    for (guint i = from; i < to; ++i) {
+        const Sample *s = &g_array_index(g_samples, Sample, i);
+        g_array_append_val(v, *(const glong *)((const char *)s + offset));
+    }
+    g_array_sort(v, compare_glong);
+    glong m = v->len ? g_array_index(v, glong, v->len / 2) : 0;
+    g_array_free(v, TRUE);
+    return m;
+}
+
+/* Compare the first and last thirds of the post-warm-up samples */
+static gboolean evaluate(void)
+{
+    guint n = g_samples->len;
+    guint warm = n / 5;
+    guint span = (n - warm) / 3;
+    if (span == 0) {
+        fprintf(stderr, "run too short to evaluate (%u samples)\n", n);
+        return FALSE;
+    }
+
+    glong rss_growth = median_of(n - span, n, G_STRUCT_OFFSET(Sample, rss_kb))
+                     - median_of(warm, warm + span, G_STRUCT_OFFSET(Sample, rss_kb));
+    glong live_growth = median_of(n - span, n, G_STRUCT_OFFSET(Sample, live))
+                      - median_of(warm, warm + span, G_STRUCT_OFFSET(Sample, live));
+
+    gdouble cost = 0;
+    guint counted = 0;
+    for (guint i = warm; i < n; ++i) {
+        const Sample *s = &g_array_index(g_samples, Sample, i);
+        if (s->cpu_us_per_event > 0) { cost += s->cpu_us_per_event; counted++; }
+    }
+    if (counted) cost /= counted;
+
+    gboolean ok = g_events > 0
+               && rss_growth <= opt_rss_budget_kb
+               && live_growth <= opt_live_budget
+               && cost <= opt_event_budget_us;
+    printf("{\"result\":\"%s\",\"events\":%" G_GUINT64_FORMAT ",\"rss_growth_kb\":%ld,"
+           "\"live_block_growth\":%ld,\"mean_cpu_us_per_event\":%.1f}\n",
+           ok ? "pass" : "fail", g_events, rss_growth, live_growth, cost);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    GError *err = NULL;
+    GOptionContext *octx = g_option_context_new("- window-event storm test for the dock");
+    g_option_context_add_main_entries(octx, stress_options, NULL);
+    g_option_context_add_group(octx, gtk_get_option_group(TRUE));
+    if (!g_option_context_parse(octx, &argc, &argv, &err)) {
+        fprintf(stderr, "%s\n", err->message);
+        return 1;
+    }
+    g_option_context_free(octx);
+
+    if (opt_generator)
+        return run_generator();
+
+    /* Same setup as the dock's main(), with the startup phases run eagerly */
+    load_favorites();
+    GtkWidget *window = create_dock_window();
+    startup_init_wnck();
+    while (startup_load_app_index())
+        ;
+    g_signal_connect(G_OBJECT(g_wnck_screen), "window-opened", G_CALLBACK(count_event), NULL);
+    g_signal_connect(G_OBJECT(g_wnck_screen), "window-closed", G_CALLBACK(count_event), NULL);
+
+    if (opt_synthetic) {
+        g_timeout_add(tick_interval_ms(), synthetic_tick, NULL);
+    } else {
+        gchar *rate = g_strdup_printf("--rate=%d", opt_rate);
+        gchar *max_open = g_strdup_printf("--max-open=%d", opt_max_open);
+        gchar *child_argv[] = { argv[0], "--generator", rate, max_open, NULL };
+        if (!g_spawn_async(NULL, child_argv, NULL, G_SPAWN_DEFAULT, NULL, NULL,
+                           &g_generator_pid, &err)) {
+            fprintf(stderr, "failed to start generator: %s\n", err->message);
+            return 1;
+        }
+        g_free(max_open);
+        g_free(rate);
+    }
+
+    g_samples = g_array_new(FALSE, FALSE, sizeof(Sample));
+    g_run_begin = g_get_monotonic_time();
+    g_last_cpu_us = read_cpu_us();
+    g_timeout_add_seconds(MAX(opt_interval, 1), sample_tick, NULL);
+    g_timeout_add_seconds(MAX(opt_duration, 1), stop_run, NULL);
+    gtk_main();
+
+    if (g_generator_pid) {
+        kill(g_generator_pid, SIGTERM);
+        g_spawn_close_pid(g_generator_pid);
+    }
+
+    gboolean ok = evaluate();
+    gtk_widget_destroy(window);
+    g_array_free(g_samples, TRUE);
+    dock_cleanup();
+    return ok ? 0 : 1;
+}
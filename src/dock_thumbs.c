@@ -0,0 +1,180 @@
+/*
+ * Check for the dock's damage-driven window previews
+ *
+ * Opens a window that repaints itself at --fps and thumbnails it through
+ * the dock's preview code (main.c) in three phases, printing one JSON line
+ * per phase:
+ *   watched   - the thumbnail is in an open preview: it must be redrawn,
+ *               at most once per THUMB_MIN_INTERVAL_MS, and end up showing
+ *               the window's last colour
+ *   unwatched - the preview is closed: no redraws, and at most one damage
+ *               event however much the window paints
+ *   lru       - thumbnailing more windows than THUMB_CACHE_SIZE evicts the
+ *               least recently used ones
+ * Exits with status 1 if any phase fails.
+ *
+ * Needs an X server with Composite and Damage, e.g.:
+ *   xvfb-run -s '+extension Composite -screen 0 1280x800x24' ./dock_thumbs
+ */
+
+#define DOCK_NO_MAIN
+#include "../main.c"
+
+/* Options */
+static gint opt_duration = 4;
+static gint opt_fps = 60;
+
+static GOptionEntry thumbs_options[] = {
+    { "duration", 'd', 0, G_OPTION_ARG_INT, &opt_duration, "Seconds per phase", "S" },
+    { "fps", 'f', 0, G_OPTION_ARG_INT, &opt_fps, "Repaints per second of the test window", "N" },
+    { NULL }
+};
+
+/* Test window painting a solid colour that changes every frame */
+static guint g_frame = 0;
+static gboolean g_animate = TRUE;
+static const guchar final_rgb[3] = { 0, 200, 0 };
+
+static gboolean on_draw(GtkWidget *widget, cairo_t *cr, gpointer data)
+{
+    if (g_animate)
+        cairo_set_source_rgb(cr, (g_frame % 3) == 0, (g_frame % 3) == 1, (g_frame % 3) == 2);
+    else
+        cairo_set_source_rgb(cr, final_rgb[0] / 255.0, final_rgb[1] / 255.0, final_rgb[2] / 255.0);
+    cairo_paint(cr);
+    return TRUE;
+}
+
+static gboolean repaint_tick(gpointer data)
+{
+    if (g_animate) g_frame++;
+    gtk_widget_queue_draw(GTK_WIDGET(data));
+    return G_SOURCE_CONTINUE;
+}
+
+static GtkWidget *open_test_window(gint w, gint h)
+{
+    GtkWidget *win = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+    GtkWidget *area = gtk_drawing_area_new();
+    gtk_window_set_default_size(GTK_WINDOW(win), w, h);
+    gtk_container_add(GTK_CONTAINER(win), area);
+    g_signal_connect(area, "draw", G_CALLBACK(on_draw), NULL);
+    gtk_widget_show_all(win);
+    return win;
+}
+
+static Window window_xid(GtkWidget *win)
+{
+    return GDK_WINDOW_XID(gtk_widget_get_window(win));
+}
+
+static gboolean stop_run(gpointer data)
+{
+    gtk_main_quit();
+    return G_SOURCE_REMOVE;
+}
+
+/* Run the main loop for ms milliseconds */
+static void run_for(guint ms)
+{
+    g_timeout_add(ms, stop_run, NULL);
+    gtk_main();
+}
+
+static gboolean report(const char *phase, gboolean ok, guint64 damage, guint64 refreshes,
+                       const char *extra)
+{
+    printf("{\"phase\":\"%s\",\"result\":\"%s\",\"damage_events\":%" G_GUINT64_FORMAT
+           ",\"refreshes\":%" G_GUINT64_FORMAT "%s}\n",
+           phase, ok ? "pass" : "fail", damage, refreshes, extra ? extra : "");
+    fflush(stdout);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    GError *err = NULL;
+    GOptionContext *octx = g_option_context_new("- check the dock's window previews");
+    g_option_context_add_main_entries(octx, thumbs_options, NULL);
+    g_option_context_add_group(octx, gtk_get_option_group(TRUE));
+    if (!g_option_context_parse(octx, &argc, &argv, &err)) {
+        fprintf(stderr, "%s\n", err->message);
+        return 1;
+    }
+    g_option_context_free(octx);
+
+    if (!thumbs_init()) {
+        fprintf(stderr, "XComposite/XDamage not available (Xvfb needs +extension Composite)\n");
+        return 1;
+    }
+
+    GtkWidget *win = open_test_window(640, 400);
+    guint repaint_id = g_timeout_add(1000 / MAX(opt_fps, 1), repaint_tick,
+                                     gtk_bin_get_child(GTK_BIN(win)));
+    run_for(200);   /* let it map */
+
+    Thumb *t = thumb_get(window_xid(win));
+    if (!t) {
+        fprintf(stderr, "could not redirect the test window\n");
+        return 1;
+    }
+    gboolean ok = TRUE;
+
+    /* watched: redrawn on damage, rate-limited, and ends on the last frame */
+    guint64 d0 = g_thumb_damage_events, r0 = g_thumb_refreshes;
+    t->watched = TRUE;
+    thumb_schedule_refresh(t);
+    run_for(opt_duration * 1000);
+    g_animate = FALSE;
+    run_for(2 * THUMB_MIN_INTERVAL_MS + 100);
+    guint64 refreshes = g_thumb_refreshes - r0;
+    guint64 limit = (guint64)(opt_duration * 1000 + 2 * THUMB_MIN_INTERVAL_MS + 100)
+                    / THUMB_MIN_INTERVAL_MS + 2;
+    gboolean colour_ok = FALSE;
+    if (t->pixbuf) {
+        const guchar *px = gdk_pixbuf_get_pixels(t->pixbuf)
+                         + (gdk_pixbuf_get_height(t->pixbuf) / 2) * gdk_pixbuf_get_rowstride(t->pixbuf)
+                         + (gdk_pixbuf_get_width(t->pixbuf) / 2) * gdk_pixbuf_get_n_channels(t->pixbuf);
+        colour_ok = ABS(px[0] - final_rgb[0]) < 8 && ABS(px[1] - final_rgb[1]) < 8
+                 && ABS(px[2] - final_rgb[2]) < 8;
+    }
+    gchar *extra = g_strdup_printf(",\"refresh_limit\":%" G_GUINT64_FORMAT ",\"thumb\":\"%dx%d\","
+                                   "\"colour_ok\":%s", limit,
+                                   t->pixbuf ? gdk_pixbuf_get_width(t->pixbuf) : 0,
+                                   t->pixbuf ? gdk_pixbuf_get_height(t->pixbuf) : 0,
+                                   colour_ok ? "true" : "false");
+    ok &= report("watched", refreshes >= 1 && refreshes <= limit && colour_ok,
+                 g_thumb_damage_events - d0, refreshes, extra);
+    g_free(extra);
+
+    /* unwatched: damage stays pending, nothing is redrawn */
+    t->watched = FALSE;
+    g_animate = TRUE;
+    d0 = g_thumb_damage_events;
+    r0 = g_thumb_refreshes;
+    run_for(opt_duration * 1000);
+    ok &= report("unwatched", g_thumb_refreshes == r0 && g_thumb_damage_events - d0 <= 1,
+                 g_thumb_damage_events - d0, g_thumb_refreshes - r0, NULL);
+    g_source_remove(repaint_id);
+
+    /* lru: the first window is the least recently used and gets evicted */
+    Window first = t->xid;
+    GPtrArray *extra_windows = g_ptr_array_new_with_free_func((GDestroyNotify)gtk_widget_destroy);
+    for (guint i = 0; i < THUMB_CACHE_SIZE; ++i)
+        g_ptr_array_add(extra_windows, open_test_window(64, 48));
+    run_for(200);
+    for (guint i = 0; i < extra_windows->len; ++i)
+        thumb_get(window_xid(g_ptr_array_index(extra_windows, i)));
+    guint cached = g_hash_table_size(g_thumbs);
+    gboolean evicted = g_hash_table_lookup(g_thumbs, GSIZE_TO_POINTER(first)) == NULL;
+    extra = g_strdup_printf(",\"cached\":%u,\"capacity\":%d,\"oldest_evicted\":%s",
+                            cached, THUMB_CACHE_SIZE, evicted ? "true" : "false");
+    ok &= report("lru", cached == THUMB_CACHE_SIZE && g_thumb_lru.length == cached && evicted,
+                 0, 0, extra);
+    g_free(extra);
+
+    free_thumbs();
+    g_ptr_array_free(extra_windows, TRUE);
+    gtk_widget_destroy(win);
+    return ok ? 0 : 1;
+}
@@ -10,14 +10,60 @@ void init_gtk() {
     }
 }
 
-// Load icon and return the path to the icon file
-char* get_icon_path(const char* icon_name, int size) {
+// Canonical icon sizes. Requests are rounded up to one of these so that
+// callers asking for, say, 44 and 48 px hit the same entry in GTK's icon
+// lookup cache instead of each getting their own.
+static const int icon_size_buckets[] = { 16, 24, 32, 48, 64, 96, 128, 256, 512 };
+
+int icon_size_bucket(int size) {
+    int n = sizeof icon_size_buckets / sizeof icon_size_buckets[0];
+    for (int i = 0; i < n; ++i) {
+        if (size <= icon_size_buckets[i]) return icon_size_buckets[i];
+    }
+    return icon_size_buckets[n - 1];
+}
+
+// TRUE if the icon is scalable or at least physical pixels large
+static gboolean icon_covers(GtkIconInfo* info, int physical) {
+    const char* path = gtk_icon_info_get_filename(info);
+    if (path && g_str_has_suffix(path, ".svg")) return TRUE;
+    int base = gtk_icon_info_get_base_size(info);
+    return base <= 0 || base * gtk_icon_info_get_base_scale(info) >= physical;
+}
+
+// Smallest fixed size of the icon that is at least physical pixels, or 0
+static int smallest_size_at_least(GtkIconTheme* theme, const char* icon_name, int physical) {
+    gint* sizes = gtk_icon_theme_get_icon_sizes(theme, icon_name);
+    int best = 0;
+    for (gint* s = sizes; s && *s; ++s) {
+        if (*s >= physical && (best == 0 || *s < best)) best = *s;
+    }
+    g_free(sizes);
+    return best;
+}
+
+// Return the path of the icon to draw at size logical pixels on a display
+// with the given scale. GTK picks the closest size for size * scale; when
+// that is smaller than the target (and not scalable), the smallest larger
+// size is used instead, so icons are scaled down rather than up.
+char* get_icon_path_for_scale(const char* icon_name, int size, int scale) {
     GtkIconTheme* theme = gtk_icon_theme_get_default();
-    if (!theme) return NULL;
+    if (!theme || !icon_name) return NULL;
+    if (scale < 1) scale = 1;
 
-    GtkIconInfo* info = gtk_icon_theme_lookup_icon(theme, icon_name, size, GTK_ICON_LOOKUP_FORCE_SIZE);
+    int bucket = icon_size_bucket(size);
+    GtkIconInfo* info = gtk_icon_theme_lookup_icon_for_scale(theme, icon_name, bucket, scale, 0);
     if (!info) return NULL;
 
+    if (!icon_covers(info, bucket * scale)) {
+        int larger = smallest_size_at_least(theme, icon_name, bucket * scale);
+        GtkIconInfo* better = larger ? gtk_icon_theme_lookup_icon(theme, icon_name, larger, 0) : NULL;
+        if (better) {
+            g_object_unref(info);
+            info = better;
+        }
+    }
+
     const char* path = gtk_icon_info_get_filename(info);
     char* result = path ? strdup(path) : NULL;
     
@@ -25,6 +71,11 @@ char* get_icon_path(const char* icon_name, int size) {
     return result;
 }
 
+// Load icon and return the path to the icon file (scale 1)
+char* get_icon_path(const char* icon_name, int size) {
+    return get_icon_path_for_scale(icon_name, size, 1);
+}
+
 // Free the memory allocated for the icon path
 void free_icon_path(char* path) {
     free(path);
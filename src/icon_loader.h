@@ -2,7 +2,9 @@
 #define ICON_LOADER_H
 
 void init_gtk();
+int icon_size_bucket(int size);
 char* get_icon_path(const char* icon_name, int size);
+char* get_icon_path_for_scale(const char* icon_name, int size, int scale);
 void free_icon_path(char* path);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,131 @@
+import 'dart:io';
+import 'package:flutter/foundation.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:vaxp_panel/common/services/icon_provider.dart';
+
+/// Icons generated in the active theme, at every size.
+const int _themeIcons = 300;
+
+/// Icons generated only in hicolor, which the active theme inherits.
+const int _hicolorIcons = 100;
+
+/// Names that resolve nowhere.
+const int _missingIcons = 20;
+
+/// Cold and warm passes over every name.
+const int _iterations = 5;
+
+const List<int> _sizes = [16, 22, 24, 32, 48, 64, 96, 128, 256, 512];
+const List<String> _contexts = [
+  'apps', 'actions', 'devices', 'categories', 'places', 'status', 'mimetypes',
+];
+
+/// Writes a theme with an index.theme listing `<size>x<size>/<context>` and
+/// `scalable/<context>` directories, and [icons] in each of its apps
+/// directories. Other contexts get a few unrelated icons.
+void _writeTheme(String path, String name, String? inherits, List<String> icons) {
+  final dirs = [
+    for (final size in _sizes)
+      for (final context in _contexts) '${size}x$size/$context',
+    for (final context in _contexts) 'scalable/$context',
+  ];
+  final index = StringBuffer()
+    ..writeln('[Icon Theme]')
+    ..writeln('Name=$name')
+    ..writeln(inherits != null ? 'Inherits=$inherits' : '')
+    ..writeln('Directories=${dirs.join(',')}');
+  for (final dir in dirs) {
+    final scalable = dir.startsWith('scalable/');
+    index
+      ..writeln()
+      ..writeln('[$dir]')
+      ..writeln('Size=${scalable ? 48 : int.parse(dir.split('x').first)}')
+      ..writeln('Type=${scalable ? 'Scalable' : 'Fixed'}');
+  }
+  Directory(path).createSync(recursive: true);
+  File('$path/index.theme').writeAsStringSync(index.toString());
+
+  for (final dir in dirs) {
+    final scalable = dir.startsWith('scalable/');
+    final ext = scalable ? 'svg' : 'png';
+    Directory('$path/$dir').createSync(recursive: true);
+    final names = dir.endsWith('/apps')
+        ? icons
+        : [for (var i = 0; i < 10; i++) '$name-${dir.split('/').last}-$i'];
+    for (final icon in names) {
+      File('$path/$dir/$icon.$ext').writeAsBytesSync(const [0]);
+    }
+  }
+}
+
+/// Resolves every name once at 48 px and returns the elapsed microseconds.
+int _lookupAll(List<String> names) {
+  final stopwatch = Stopwatch()..start();
+  for (final name in names) {
+    IconProvider.findIcon(name, size: 48, scale: 1.0);
+  }
+  return stopwatch.elapsedMicroseconds;
+}
+
+int _median(List<int> samples) => ([...samples]..sort())[samples.length ~/ 2];
+
+void main() {
+  late Directory corpus;
+  late String themePath;
+  late String hicolorPath;
+  final themeNames = [for (var i = 0; i < _themeIcons; i++) 'bench-app-$i'];
+  final hicolorNames = [for (var i = 0; i < _hicolorIcons; i++) 'bench-hicolor-$i'];
+  final missingNames = [for (var i = 0; i < _missingIcons; i++) 'bench-missing-$i'];
+  final names = [...themeNames, ...hicolorNames, ...missingNames];
+
+  setUpAll(() {
+    corpus = Directory.systemTemp.createTempSync('icon-provider-bench-');
+    themePath = '${corpus.path}/icons/vaxp-bench';
+    hicolorPath = '${corpus.path}/icons/hicolor';
+    _writeTheme(themePath, 'vaxp-bench', 'hicolor', themeNames);
+    _writeTheme(hicolorPath, 'hicolor', null, hicolorNames);
+
+    IconProvider.debugBases = ['${corpus.path}/icons'];
+    IconProvider.debugThemeName = 'vaxp-bench';
+    IconProvider.invalidate();
+  });
+
+  tearDownAll(() {
+    IconProvider.debugBases = null;
+    IconProvider.debugThemeName = null;
+    IconProvider.invalidate();
+    corpus.deleteSync(recursive: true);
+  });
+
+  test('findIcon resolves the generated theme', () {
+    IconProvider.invalidate();
+    expect(IconProvider.findIcon('bench-app-7', size: 48, scale: 1.0),
+        '$themePath/48x48/apps/bench-app-7.png');
+    expect(IconProvider.findIcon('bench-app-7', size: 44, scale: 2.0),
+        '$themePath/96x96/apps/bench-app-7.png');
+    expect(IconProvider.findIcon('bench-hicolor-3', size: 48, scale: 1.0),
+        '$hicolorPath/48x48/apps/bench-hicolor-3.png');
+    expect(IconProvider.findIcon('bench-missing-0', size: 48, scale: 1.0), isNull);
+  });
+
+  test('findIcon benchmark: warm lookups are served from the cache', () {
+    final cold = <int>[];
+    final warm = <int>[];
+    for (var i = 0; i < _iterations; i++) {
+      IconProvider.invalidate();
+      cold.add(_lookupAll(names));
+      warm.add(_lookupAll(names));
+    }
+
+    final coldMedian = _median(cold);
+    final warmMedian = _median(warm);
+    debugPrint('{"bench":"IconProvider.findIcon","ops":${names.length},'
+        '"iterations":$_iterations,'
+        '"cold_p50_us":$coldMedian,"warm_p50_us":$warmMedian,'
+        '"cold_ns_per_op":${(coldMedian * 1000 / names.length).toStringAsFixed(1)},'
+        '"warm_ns_per_op":${(warmMedian * 1000 / names.length).toStringAsFixed(1)}}');
+
+    expect(warmMedian, lessThan(coldMedian),
+        reason: 'a warm lookup must not touch the file system');
+  });
+}
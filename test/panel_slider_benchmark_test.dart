@@ -0,0 +1,146 @@
+import 'dart:io';
+import 'package:flutter/material.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:vaxp_panel/common/services/frame_stats.dart';
+import 'package:vaxp_panel/main.dart' as shell;
+import 'package:vaxp_panel/panel/main.dart' as panel;
+import 'package:vaxp_panel/panel/services/system_state.dart';
+
+/// Number of slider drags, one frame each.
+const int _frames = 30;
+
+/// Upper bound on elements rebuilt per frame inside the dragged slider's row.
+/// A whole-panel rebuild is an order of magnitude more.
+const int _maxSliderRebuildsPerFrame = 100;
+
+/// Stands in for the system: no processes are spawned and nothing on the
+/// host changes. Writes are only recorded.
+class _FakeBackend extends SystemBackend {
+  final List<double> volumeWrites = [];
+  final List<double> brightnessWrites = [];
+
+  @override
+  Future<bool> wifiEnabled() async => true;
+  @override
+  Future<bool> bluetoothEnabled() async => false;
+  @override
+  Future<bool> airplaneMode() async => false;
+  @override
+  Future<double> volume() async => 0.5;
+  @override
+  Future<double> brightness() async => 0.75;
+  @override
+  Future<void> setVolume(double value) async => volumeWrites.add(value);
+  @override
+  Future<void> setBrightness(double value) async => brightnessWrites.add(value);
+  @override
+  Future<Process> startMonitor(String cmd, List<String> args) =>
+      Future.error(ProcessException(cmd, args, 'not started in tests'));
+}
+
+/// Counts element rebuilds by the isolated subtree they belong to.
+class _RebuildCounter {
+  final Map<String, int> _counts = {};
+
+  int operator [](String subtree) => _counts[subtree] ?? 0;
+
+  void _onRebuild(Element element, bool builtOnce) {
+    String? subtree = _classify(element.widget);
+    element.visitAncestorElements((ancestor) {
+      subtree ??= _classify(ancestor.widget);
+      return subtree == null;
+    });
+    _counts.update(subtree ?? 'other', (n) => n + 1, ifAbsent: () => 1);
+  }
+
+  static String? _classify(Widget widget) {
+    if (widget is ValueListenableBuilder<DateTime>) return 'clock';
+    if (widget is ValueListenableBuilder<List<shell.DesktopEntry>>) return 'dock';
+    if (widget is ValueListenableBuilder<double>) return 'slider';
+    return null;
+  }
+}
+
+/// Drags [slider] once per frame and returns the rebuilds and the wall time
+/// of each frame.
+Future<(_RebuildCounter, List<int>)> _dragSlider(
+  WidgetTester tester,
+  Finder slider,
+) async {
+  final counter = _RebuildCounter();
+  final frameMicros = <int>[];
+  debugOnRebuildDirtyWidget = counter._onRebuild;
+  try {
+    for (var i = 0; i < _frames; i++) {
+      await tester.drag(slider, Offset(-20.0 - i, 0));
+      final stopwatch = Stopwatch()..start();
+      await tester.pump();
+      frameMicros.add(stopwatch.elapsedMicroseconds);
+    }
+  } finally {
+    debugOnRebuildDirtyWidget = null;
+  }
+  return (counter, frameMicros);
+}
+
+int _median(List<int> samples) => ([...samples]..sort())[samples.length ~/ 2];
+
+Future<_FakeBackend> _openQuickSettings(WidgetTester tester, Widget app) async {
+  tester.view.physicalSize = const Size(1920, 1080);
+  tester.view.devicePixelRatio = 1.0;
+  addTearDown(tester.view.reset);
+
+  final backend = _FakeBackend();
+  final state = SystemState.instance;
+  state.backend = backend;
+  addTearDown(() {
+    state.dispose();
+    state.backend = const SystemBackend();
+  });
+  await state.ensureStarted();
+
+  await tester.pumpWidget(app);
+  await tester.tap(find.byTooltip('Quick Settings'));
+  await tester.pumpAndSettle();
+  expect(find.byType(Slider), findsWidgets);
+  return backend;
+}
+
+void _expectOnlySliderRebuilt(_RebuildCounter counter, List<int> frameMicros) {
+  expect(counter['clock'], 0, reason: 'the clock must not rebuild');
+  expect(counter['slider'], greaterThanOrEqualTo(_frames),
+      reason: 'every drag should rebuild the slider row');
+  expect(counter['slider'], lessThanOrEqualTo(_frames * _maxSliderRebuildsPerFrame));
+  // One-off focus changes are fine; nothing else may rebuild every frame.
+  expect(counter['other'], lessThan(_frames));
+  expect(_median(frameMicros), lessThan(FrameStats.budget.inMicroseconds));
+}
+
+void main() {
+  testWidgets('dragging a slider in the shell panel rebuilds only its row',
+      (tester) async {
+    final backend = await _openQuickSettings(tester, const shell.PanelApp());
+    final before = SystemState.instance.brightness.value;
+
+    final (counter, frameMicros) =
+        await _dragSlider(tester, find.byType(Slider).first);
+
+    expect(SystemState.instance.brightness.value, isNot(before));
+    expect(backend.brightnessWrites.last, SystemState.instance.brightness.value);
+    expect(counter['dock'], 0, reason: 'the dock row must not rebuild');
+    _expectOnlySliderRebuilt(counter, frameMicros);
+  });
+
+  testWidgets('dragging a slider in the split panel rebuilds only its row',
+      (tester) async {
+    final backend = await _openQuickSettings(tester, const panel.PanelApp());
+    final before = SystemState.instance.volume.value;
+
+    final (counter, frameMicros) =
+        await _dragSlider(tester, find.byType(Slider).last);
+
+    expect(SystemState.instance.volume.value, isNot(before));
+    expect(backend.volumeWrites.last, SystemState.instance.volume.value);
+    _expectOnlySliderRebuilt(counter, frameMicros);
+  });
+}
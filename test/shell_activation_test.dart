@@ -0,0 +1,72 @@
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:vaxp_panel/common/services/surface_channel.dart';
+import 'package:vaxp_panel/shell/main.dart';
+
+const MethodChannel _surfaces = MethodChannel('vaxp_panel/surfaces');
+const StandardMethodCodec _codec = StandardMethodCodec();
+
+/// Delivers an `activate` call the way the runner forwards a second
+/// `vaxp_panel` invocation, and returns what would be printed.
+Future<String?> _activate(List<String> args) async {
+  ByteData? reply;
+  await TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+      .handlePlatformMessage(
+    'vaxp_panel/instance',
+    _codec.encodeMethodCall(MethodCall('activate', args)),
+    (data) => reply = data,
+  );
+  expect(reply, isNotNull, reason: 'the shell must answer activations');
+  return _codec.decodeEnvelope(reply!) as String?;
+}
+
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+  final surfaceCalls = <MethodCall>[];
+
+  setUpAll(() async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(_surfaces, (call) async {
+      surfaceCalls.add(call);
+      if (call.method == 'createSurfaces') {
+        return <String, int>{'panel': 0, 'dock': 1, 'launcher': 2};
+      }
+      return null;
+    });
+    await SurfaceChannel.createSurfaces();
+    ShellActivation.register();
+  });
+
+  setUp(surfaceCalls.clear);
+
+  test('--launcher toggles the launcher surface', () async {
+    expect(await _activate(['--launcher']), isNull);
+    await pumpEventQueue();
+    expect(await _activate(['--launcher']), isNull);
+    await pumpEventQueue();
+
+    final visibility = [
+      for (final call in surfaceCalls)
+        if (call.method == 'setSurfaceVisible') call.arguments as Map,
+    ];
+    expect(visibility, [
+      {'role': 'launcher', 'visible': true},
+      {'role': 'launcher', 'visible': false},
+    ]);
+  });
+
+  test('stats flags return their reports', () async {
+    final reply = await _activate(['--wakeup-stats', '--frame-stats']);
+    expect(reply, isNotNull);
+    final lines = reply!.split('\n');
+    expect(lines, hasLength(2));
+    expect(lines[0], startsWith('wakeups:'));
+    expect(lines[1], startsWith('frames:'));
+  });
+
+  test('other arguments return nothing and touch no surface', () async {
+    expect(await _activate(['--unknown']), isNull);
+    await pumpEventQueue();
+    expect(surfaceCalls, isEmpty);
+  });
+}